@@ -0,0 +1,157 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "fmt/format.h"
+
+#include "engine.hpp"
+#include "engine_parse.hpp"
+
+#include "pattern.hpp"
+
+#include "profile_allocation.hpp"
+
+// Peak Memory ----------------------------------
+// linux keeps the peak resident set in VmHWM, writing 5 to clear_refs resets it
+auto reset_peak_memory() -> void {
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  if (clear_refs) clear_refs << "5";
+}
+
+auto peak_memory_kb() -> uint64_t {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.starts_with("VmHWM:")) return std::stoull(line.substr(6));
+  }
+  return 0;
+}
+// ----------------------------------------------
+
+struct workload_t {
+  std::string name;
+  pattern::coords_t coords;
+  uint64_t generations;
+};
+
+auto workloads(const bool quick) -> std::vector<workload_t> {
+  uint64_t scale = quick ? 10 : 1;
+
+  std::vector<workload_t> list;
+  list.push_back({"rpentomino", pattern::rpentomino(0, 0), 5000 / scale});
+  list.push_back({"acorn", pattern::acorn(), 5000 / scale});
+  list.push_back({"gosper_glider_gun", pattern::gosper_glider_gun(), 5000 / scale});
+  list.push_back({"one_line_growth", pattern::one_line_growth(), 5000 / scale});
+  list.push_back({"max_spacefiller", pattern::max_spacefiller(), 1000 / scale});
+  for (const int size : {256, 1024}) {
+    for (const double density : {0.1, 0.35, 0.5}) list.push_back({fmt::format("soup_{}_{:.2f}", size, density), pattern::soup(size, size, density, 1), (size == 256 ? 1000 : 200) / scale});
+  }
+  return list;
+}
+
+struct result_t {
+  uint64_t generations{0};
+  size_t initial_population{0};
+  size_t final_population{0};
+  uint64_t cell_generations{0};
+  double seconds{0.0};
+  uint64_t peak_memory_kb{0};
+  uint64_t allocations{0};
+  uint64_t allocated_bytes{0};
+
+  // allocations over the second half of the run, once the engine has warmed up
+  uint64_t steady_allocations{0};
+};
+
+auto run(const workload_t& workload, const engine::kind_e kind, const size_t threads, const bool colorless, const engine::rule::rule_t rule) -> result_t {
+  std::vector<engine::cell_t> cells;
+  for (const auto& coord : workload.coords) cells.push_back(engine::cell_t{coord, {255, 255, 255}});
+
+  result_t result;
+  result.initial_population = cells.size();
+
+  engine::engine_t engine;
+  engine.kind = kind;
+  engine::set_threads(engine, threads);
+  engine::set_colorless(engine, colorless);
+  engine::set_rule(engine, rule);
+
+  reset_peak_memory();
+  profile::allocation::watch_t watch;
+  profile::allocation::watch_t steady;
+  auto begin = std::chrono::steady_clock::now();
+
+  while (engine.generation < workload.generations) {
+    if (engine.generation < workload.generations / 2) steady = profile::allocation::watch_t();
+    result.cell_generations += cells.size();
+    engine::step(engine, cells);
+  }
+
+  result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  result.allocations = watch.allocated();
+  result.allocated_bytes = watch.allocated_bytes();
+  result.steady_allocations = steady.allocated();
+  result.peak_memory_kb = peak_memory_kb();
+  result.generations = engine.generation;
+  result.final_population = cells.size();
+  return result;
+}
+
+auto main(int argc, char** argv) -> int {
+  std::vector<engine::kind_e> kinds{engine::kind_e::sparse, engine::kind_e::tile, engine::kind_e::hashlife};
+  size_t threads = std::thread::hardware_concurrency();
+  bool quick = false;
+  bool colorless = false;
+  engine::rule::rule_t rule = engine::rule::conway;
+
+  for (int arg = 1; arg < argc; ++arg) {
+    std::string_view option = argv[arg];
+    bool has_value = arg + 1 < argc;
+
+    engine::kind_e kind;
+    engine::rule::rule_t parsed;
+    if (option == "--engine" && has_value && engine::parse_kind(argv[++arg], kind)) {
+      kinds = {kind};
+    } else if (option == "--threads" && has_value && engine::parse_number(argv[++arg], threads)) {
+    } else if (option == "--quick") {
+      quick = true;
+    } else if (option == "--colorless") {
+      colorless = true;
+    } else if (option == "--rule" && has_value && engine::rule::parse(argv[++arg], parsed)) {
+      rule = parsed;
+    } else {
+      fmt::print(stderr, "usage: {} [--engine sparse|tile|hashlife|ltl] [--threads count] [--quick] [--colorless] [--rule B3/S23]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  fmt::print("{{\n  \"threads\": {},\n  \"colorless\": {},\n  \"rule\": \"{}\",\n  \"results\": [", threads, colorless, engine::rule::format(rule));
+
+  bool first = true;
+  for (const auto& workload : workloads(quick)) {
+    for (const auto kind : kinds) {
+      result_t result = run(workload, kind, threads, colorless, rule);
+      double generations_per_second = result.seconds > 0.0 ? static_cast<double>(result.generations) / result.seconds : 0.0;
+      double cells_per_second = result.seconds > 0.0 ? static_cast<double>(result.cell_generations) / result.seconds : 0.0;
+
+      fmt::print("{}\n    {{\"workload\": \"{}\", \"engine\": \"{}\", \"generations\": {}, \"initial_population\": {}, \"final_population\": {}, ", first ? "" : ",", workload.name, engine::kind_name(kind),
+                 result.generations, result.initial_population, result.final_population);
+      fmt::print("\"seconds\": {:.6f}, \"generations_per_second\": {:.1f}, \"cells_per_second\": {:.0f}, ", result.seconds, generations_per_second, cells_per_second);
+      fmt::print("\"peak_memory_kb\": {}, \"allocations\": {}, \"allocated_bytes\": {}, \"steady_allocations\": {}}}", result.peak_memory_kb, result.allocations, result.allocated_bytes, result.steady_allocations);
+      std::fflush(stdout);
+      first = false;
+    }
+  }
+
+  fmt::print("\n  ]\n}}\n");
+  return 0;
+}
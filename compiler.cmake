@@ -4,3 +4,15 @@ message("-- build type: ${CMAKE_BUILD_TYPE}")
 set(CMAKE_CXX_STANDARD 20)
 set(CMAKE_CXX_STANDARD_REQUIRED ON)
 message("-- c++ standard: ${CMAKE_CXX_STANDARD}")
+
+option(LIFE_NATIVE "optimise for the instruction set of the build machine" ON)
+if (LIFE_NATIVE)
+  add_compile_options(-march=native)
+endif()
+message("-- native: ${LIFE_NATIVE}")
+
+option(LIFE_PROFILE "build the phase timers and engine counters" ON)
+if (LIFE_PROFILE)
+  add_compile_definitions(LIFE_PROFILE)
+endif()
+message("-- profile: ${LIFE_PROFILE}")
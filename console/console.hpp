@@ -6,6 +6,12 @@
 
 #pragma once
 
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "fmt/format.h"
+
 #include "console_initialise.hpp"
 #include "console_mouse.hpp"
 
@@ -28,6 +34,20 @@ struct console_t {
   
   int render_x;
   int render_y;
+
+  // retained panel, what each row shows so a frame only redraws the rows that changed
+  std::vector<std::string> rows;
+  int rows_used{0};
+  int width{0};
+  int height{0};
+  bool redraw{true};
+
+  // reused by every formatted line
+  fmt::memory_buffer buffer;
+
+  // panel frames per second, frames in between are skipped
+  double refresh_rate{10.0};
+  std::chrono::steady_clock::time_point last_refresh;
 };
 
 }  // namespace console
@@ -6,8 +6,13 @@
 
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <iterator>
 #include <string_view>
 
+#include "fmt/format.h"
+
 #include "console.hpp"
 #include "console_draw.hpp"
 
@@ -15,8 +20,47 @@
 
 namespace console::render {
 
+// true when a panel frame is due at the refresh rate
+auto due(console_t& console) -> bool {
+  auto now = std::chrono::steady_clock::now();
+  if (console.refresh_rate > 0.0 && now - console.last_refresh < std::chrono::duration<double>(1.0 / console.refresh_rate)) return false;
+  console.last_refresh = now;
+  return true;
+}
+
+// when the next panel frame will be due
+auto next_due(const console_t& console) -> std::chrono::steady_clock::time_point {
+  if (console.refresh_rate <= 0.0) return console.last_refresh;
+  return console.last_refresh + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / console.refresh_rate));
+}
+
+// stores text as what row y shows, returns true when the row has to be drawn
+auto retain(console_t& console, const int y, std::string_view text) -> bool {
+  if (y < 0 || y >= static_cast<int>(console.rows.size())) return false;
+  if (!console.redraw && console.rows[y] == text) return false;
+  console.rows[y].assign(text);
+  return true;
+}
+
+// blanks row y, restoring the side borders a divider may have left as tees
+auto clear_row(console_t& console, const int y) -> void {
+  mvwhline(stdscr, y, 0, ' ', getmaxx(stdscr));
+  if (!console.border) return;
+  mvwaddch(stdscr, y, 0, ACS_VLINE);
+  mvwaddch(stdscr, y, getmaxx(stdscr) - 1, ACS_VLINE);
+}
+
+// starts a frame, the screen is only erased on the first frame and after a resize
 auto erase(console_t& console) -> void {
-  werase(stdscr);
+  int width = getmaxx(stdscr);
+  int height = getmaxy(stdscr);
+  if (width != console.width || height != console.height) {
+    console.width = width;
+    console.height = height;
+    console.rows.assign(height, std::string());
+    console.redraw = true;
+  }
+  if (console.redraw) werase(stdscr);
 
   console.border = false;
 
@@ -27,7 +71,7 @@ auto erase(console_t& console) -> void {
 }
 
 auto border(console_t& console) -> void {
-  wborder(stdscr, 0, 0, 0, 0, 0, 0, 0, 0);
+  if (console.redraw) wborder(stdscr, 0, 0, 0, 0, 0, 0, 0, 0);
 
   console.border = true;
 
@@ -38,6 +82,14 @@ auto border(console_t& console) -> void {
 }
 
 auto header(console_t& console, std::string_view left, std::string_view center, std::string_view right) -> void {
+  console.buffer.clear();
+  fmt::format_to(std::back_inserter(console.buffer), "{}\x1f{}\x1f{}", left, center, right);
+  if (!retain(console, 1, std::string_view(console.buffer.data(), console.buffer.size()))) {
+    console.render_x = console.border ? 1 : 0;
+    console.render_y = 3;
+    return;
+  }
+
   // header_top_border
   console::draw::horizontal_top_border(0);
 
@@ -130,7 +182,10 @@ auto text(console_t& console, std::string_view text) -> void {
 }
 
 auto line(console_t& console, std::string_view line) -> void {
-  mvwprintw(stdscr, console.render_y, console.render_x, "%s", line.begin());
+  if (retain(console, console.render_y, line)) {
+    clear_row(console, console.render_y);
+    mvwaddnstr(stdscr, console.render_y, console.render_x, line.data(), static_cast<int>(line.size()));
+  }
 
   // update where the next render should occur --
   console.render_x = console.border ? 1 : 0;
@@ -138,14 +193,37 @@ auto line(console_t& console, std::string_view line) -> void {
   // --------------------------------------------
 }
 
+// formats into the console's buffer rather than a fresh string
+template <typename... args_t>
+auto line(console_t& console, fmt::format_string<args_t...> format, args_t&&... args) -> void {
+  console.buffer.clear();
+  fmt::format_to(std::back_inserter(console.buffer), format, std::forward<args_t>(args)...);
+  line(console, std::string_view(console.buffer.data(), console.buffer.size()));
+}
+
 auto divider(console_t& console) -> void {
-  console::draw::horizontal_border(console.render_y);
-  if (!console.border) mvwaddch(stdscr, console.render_y, 0, ACS_HLINE);
-  if (!console.border) mvwaddch(stdscr, console.render_y, getmaxx(stdscr) - 1, ACS_HLINE);
+  if (retain(console, console.render_y, "\x1f")) {
+    console::draw::horizontal_border(console.render_y);
+    if (!console.border) mvwaddch(stdscr, console.render_y, 0, ACS_HLINE);
+    if (!console.border) mvwaddch(stdscr, console.render_y, getmaxx(stdscr) - 1, ACS_HLINE);
+  }
 
   // update where the next render should occur --
   ++console.render_y;
   // --------------------------------------------
 }
 
+// ends a frame, clearing the rows the last frame used that this one did not
+auto finish(console_t& console) -> void {
+  int used = std::min(console.render_y, static_cast<int>(console.rows.size()));
+  for (int y = used; y < console.rows_used; ++y) {
+    if (console.rows[y].empty()) continue;
+    clear_row(console, y);
+    console.rows[y].clear();
+  }
+
+  console.rows_used = used;
+  console.redraw = false;
+}
+
 }  // namespace console::render
\ No newline at end of file
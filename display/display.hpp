@@ -32,4 +32,12 @@ struct display_t {
   }
 };
 
+// frames per second of the screen the window is on, 60 when it does not say
+auto refresh_rate(const display_t& display) -> int {
+  SDL_DisplayMode mode;
+  int index = SDL_GetWindowDisplayIndex(display.window);
+  if (index < 0 || SDL_GetCurrentDisplayMode(index, &mode) != 0 || mode.refresh_rate <= 0) return 60;
+  return mode.refresh_rate;
+}
+
 }  // namespace display
\ No newline at end of file
@@ -0,0 +1,45 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Display Batch Functions
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "SDL.h"
+
+namespace display::batch {
+
+// rectangles bucketed by colour at 4 bits per channel, each bucket is one SDL_RenderFillRects call
+constexpr int bucket_count = 1 << 12;
+
+struct batch_t {
+  std::array<std::vector<SDL_Rect>, bucket_count> buckets;
+  std::vector<uint16_t> used;
+};
+
+auto bucket(const uint8_t red, const uint8_t green, const uint8_t blue) -> uint16_t { return static_cast<uint16_t>((red >> 4) << 8 | (green >> 4) << 4 | (blue >> 4)); }
+
+auto add(batch_t& batch, const uint8_t red, const uint8_t green, const uint8_t blue, const SDL_Rect& rect) -> void {
+  uint16_t index = bucket(red, green, blue);
+  auto& rects = batch.buckets[index];
+  if (rects.empty()) batch.used.push_back(index);
+  rects.push_back(rect);
+}
+
+// draws every bucket with the centre of its colour range, the buckets keep their storage
+auto submit(batch_t& batch, SDL_Renderer* renderer) -> void {
+  for (const auto index : batch.used) {
+    auto& rects = batch.buckets[index];
+    auto channel = [index](const int shift) -> uint8_t { return static_cast<uint8_t>(((index >> shift) & 0xF) << 4 | 0x8); };
+    SDL_SetRenderDrawColor(renderer, channel(8), channel(4), channel(0), SDL_ALPHA_OPAQUE);
+    SDL_RenderFillRects(renderer, rects.data(), static_cast<int>(rects.size()));
+    rects.clear();
+  }
+  batch.used.clear();
+}
+
+}  // namespace display::batch
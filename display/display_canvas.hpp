@@ -0,0 +1,54 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Display Canvas Functions
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "SDL.h"
+
+namespace display::canvas {
+
+// a window sized streaming texture, written one ARGB pixel at a time and uploaded once per frame
+struct canvas_t {
+  SDL_Texture* texture{nullptr};
+  int width{0};
+  int height{0};
+  std::vector<uint32_t> pixels;
+
+  canvas_t() = default;
+  canvas_t(const canvas_t&) = delete;
+  auto operator=(const canvas_t&) -> canvas_t& = delete;
+
+  ~canvas_t() {
+    if (texture != nullptr) SDL_DestroyTexture(texture);
+  }
+};
+
+auto resize(canvas_t& canvas, SDL_Renderer* renderer, const int width, const int height) -> void {
+  if (canvas.texture != nullptr && canvas.width == width && canvas.height == height) return;
+
+  if (canvas.texture != nullptr) SDL_DestroyTexture(canvas.texture);
+  canvas.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, width, height);
+  canvas.width = width;
+  canvas.height = height;
+  canvas.pixels.assign(static_cast<size_t>(width) * height, 0xFF000000);
+}
+
+auto clear(canvas_t& canvas) -> void { std::ranges::fill(canvas.pixels, 0xFF000000); }
+
+auto pixel(const uint8_t red, const uint8_t green, const uint8_t blue) -> uint32_t { return 0xFF000000 | uint32_t{red} << 16 | uint32_t{green} << 8 | blue; }
+
+auto set(canvas_t& canvas, const int x, const int y, const uint32_t value) -> void { canvas.pixels[static_cast<size_t>(y) * canvas.width + x] = value; }
+
+auto present(canvas_t& canvas, SDL_Renderer* renderer) -> void {
+  if (canvas.texture == nullptr) return;
+  SDL_UpdateTexture(canvas.texture, nullptr, canvas.pixels.data(), canvas.width * static_cast<int>(sizeof(uint32_t)));
+  SDL_RenderCopy(renderer, canvas.texture, nullptr, nullptr);
+}
+
+}  // namespace display::canvas
@@ -0,0 +1,95 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Display Wake Functions
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <poll.h>
+#include <unistd.h>
+
+#include "SDL.h"
+
+namespace display::wake {
+
+// wakes a loop asleep in SDL_WaitEventTimeout from other threads, at most one wake event is
+// queued at a time however often it is signalled, clear once its inputs are drained re-arms it
+struct wake_t {
+  Uint32 event{0};
+  std::atomic<bool> pending{false};
+
+  // a thread polling a file descriptor, such as the terminal, that signals when it is readable
+  std::thread thread;
+  std::mutex mutex;
+  std::condition_variable cleared;
+  int stop_pipe[2]{-1, -1};
+  bool stopping{false};
+
+  wake_t() { event = SDL_RegisterEvents(1); }
+  wake_t(const wake_t&) = delete;
+  auto operator=(const wake_t&) -> wake_t& = delete;
+
+  ~wake_t() {
+    if (thread.joinable()) {
+      {
+        std::scoped_lock lock(mutex);
+        stopping = true;
+      }
+      cleared.notify_one();
+      char byte = 0;
+      [[maybe_unused]] auto written = write(stop_pipe[1], &byte, 1);
+      thread.join();
+    }
+    if (stop_pipe[0] >= 0) close(stop_pipe[0]);
+    if (stop_pipe[1] >= 0) close(stop_pipe[1]);
+  }
+};
+
+// thread safe, pushes the wake event unless one is already queued
+auto signal(wake_t& wake) -> void {
+  if (wake.pending.exchange(true, std::memory_order_acq_rel)) return;
+
+  SDL_Event event{};
+  event.type = wake.event;
+  SDL_PushEvent(&event);
+}
+
+auto signal_context(void* context) -> void { signal(*static_cast<wake_t*>(context)); }
+
+// the loop's side, called before it reads what it was woken for
+auto clear(wake_t& wake) -> void {
+  {
+    std::scoped_lock lock(wake.mutex);
+    wake.pending.store(false, std::memory_order_release);
+  }
+  wake.cleared.notify_one();
+}
+
+// a readable descriptor stays readable until the loop reads it, so the thread waits for the
+// wake to be cleared before it polls again
+auto watch(wake_t& wake, const int fd) -> bool {
+  if (pipe(wake.stop_pipe) != 0) return false;
+
+  wake.thread = std::thread([&wake, fd] {
+    pollfd fds[2]{{fd, POLLIN, 0}, {wake.stop_pipe[0], POLLIN, 0}};
+    while (true) {
+      if (poll(fds, 2, -1) < 0) continue;
+      if (fds[1].revents != 0) return;
+      if (fds[0].revents & (POLLERR | POLLHUP | POLLNVAL)) return;
+
+      signal(wake);
+      std::unique_lock lock(wake.mutex);
+      wake.cleared.wait(lock, [&wake] { return wake.stopping || !wake.pending.load(std::memory_order_acquire); });
+      if (wake.stopping) return;
+    }
+  });
+  return true;
+}
+
+}  // namespace display::wake
@@ -0,0 +1,290 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Engine Library
+
+#pragma once
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+#include "engine_cell.hpp"
+#include "engine_hashlife.hpp"
+#include "engine_ltl.hpp"
+#include "engine_pool.hpp"
+#include "engine_rule.hpp"
+#include "engine_sparse.hpp"
+#include "engine_tile.hpp"
+#include "engine_world.hpp"
+#include "profile.hpp"
+
+namespace engine {
+
+// ltl runs larger than life rules, the others run the B/S rule
+enum struct kind_e { sparse, tile, hashlife, ltl };
+
+struct engine_t {
+  kind_e kind{kind_e::sparse};
+
+  sparse::sparse_t sparse;
+  tile::tiles_t tiles;
+  hashlife::hashlife_t hashlife;
+  ltl::ltl_t ltl;
+
+  // a finite world steps in place of the selected engine
+  world::world_t world;
+
+  // workers shared by the engines that step in parallel
+  pool::pool_t pool;
+
+  // steps cells somewhere else in place of every engine, set by the sharded coordinator
+  void (*remote_step)(engine_t&, std::vector<cell_t>&, void*){nullptr};
+  void* remote{nullptr};
+
+  // colours of the previous generation, used to colour engines that only track topology
+  sparse::table_t<color_t> colors;
+
+  // skips colour entirely, every cell comes out white
+  bool colorless{false};
+
+  rule::rule_t rule{rule::conway};
+
+  // false when cells have been edited since the engine last produced them
+  bool synced{false};
+
+  uint64_t generation{0};
+
+  // bumped whenever cells may have changed, by an edit or a step
+  uint64_t revision{0};
+
+  // engines that can jump advance 2^step_exponent generations per step
+  int step_exponent{0};
+};
+
+auto kind_name(const kind_e kind) -> std::string_view {
+  switch (kind) {
+    case kind_e::sparse: return "sparse";
+    case kind_e::tile: return "tile";
+    case kind_e::hashlife: return "hashlife";
+    case kind_e::ltl: return "ltl";
+  }
+  return "";
+}
+
+auto parse_kind(std::string_view name, kind_e& kind) -> bool {
+  for (auto candidate : {kind_e::sparse, kind_e::tile, kind_e::hashlife, kind_e::ltl}) {
+    if (kind_name(candidate) == name) {
+      kind = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+auto next_kind(const kind_e kind) -> kind_e {
+  switch (kind) {
+    case kind_e::sparse: return kind_e::tile;
+    case kind_e::tile: return kind_e::hashlife;
+    case kind_e::hashlife: return kind_e::sparse;
+    case kind_e::ltl: return kind_e::sparse;
+  }
+  return kind_e::sparse;
+}
+
+// call whenever cells are changed outside of step
+auto touch(engine_t& engine) -> void {
+  engine.synced = false;
+  ++engine.revision;
+}
+
+auto set_threads(engine_t& engine, const size_t threads) -> void { pool::resize(engine.pool, threads); }
+
+auto set_colorless(engine_t& engine, const bool colorless) -> void {
+  engine.colorless = colorless;
+  touch(engine);
+}
+
+auto set_rule(engine_t& engine, const rule::rule_t rule) -> void {
+  engine.rule = rule;
+  touch(engine);
+}
+
+auto set_ltl_rule(engine_t& engine, const ltl::rule_t& rule) -> void {
+  engine.ltl.rule = rule;
+  touch(engine);
+}
+
+auto set_world(engine_t& engine, const world::topology_e topology, const int width, const int height) -> void {
+  engine.world.colored = !engine.colorless;
+  world::resize(engine.world, topology, width, height);
+  touch(engine);
+}
+
+auto select(engine_t& engine, const kind_e kind) -> void {
+  engine.kind = kind;
+  touch(engine);
+}
+
+// a B/S rulestring keeps the selected engine unless it is the ltl engine, which cannot run it and
+// gives way to the sparse one, a larger than life rulestring selects the ltl engine, false when
+// the text is neither or a finite world, which steps B/S rules only, would have to run it
+auto set_rulestring(engine_t& engine, const std::string_view text) -> bool {
+  rule::rule_t rule;
+  ltl::rule_t ltl_rule;
+  if (rule::parse(text, rule)) {
+    set_rule(engine, rule);
+    if (engine.kind == kind_e::ltl) select(engine, kind_e::sparse);
+    return true;
+  }
+  if (!ltl::parse(text, ltl_rule) || world::finite(engine.world)) return false;
+  set_ltl_rule(engine, ltl_rule);
+  select(engine, kind_e::ltl);
+  return true;
+}
+
+// survivors keep their colour, births take the mean colour of their previous neighbours
+auto index_colors(engine_t& engine, const std::vector<cell_t>& cells) -> void {
+  sparse::clear(engine.colors);
+  sparse::reserve(engine.colors, cells.size());
+  for (const auto& cell : cells) *sparse::insert(engine.colors, pack_coord(cell.coord)).first = cell.color;
+}
+
+auto resolve_color(engine_t& engine, const int x, const int y) -> color_t {
+  if (auto found = sparse::find(engine.colors, pack_coord(x, y))) return *found;
+
+  color_sum_t sum{0, 0, 0};
+  int count = 0;
+  for (const auto& [delta_x, delta_y] : neighbour_deltas) {
+    auto parent = sparse::find(engine.colors, pack_coord(x + delta_x, y + delta_y));
+    if (parent == nullptr) continue;
+    accumulate_color(sum, *parent);
+    ++count;
+  }
+  return blend_colors(sum, count);
+}
+
+// the tiles carry their own colour planes
+auto step_tiles(engine_t& engine, std::vector<cell_t>& cells) -> void {
+  if (!engine.synced) {
+    engine.tiles.colored = !engine.colorless;
+    tile::load(engine.tiles, cells);
+  }
+
+  {
+    profile::scope_t scope(profile::timer_e::engine_step);
+    engine.tiles.rule = engine.rule;
+    rule::dispatch(engine.rule, [&]<rule::packed_t packed>() { tile::step<packed>(engine.tiles, engine.pool); });
+  }
+
+  profile::scope_t scope(profile::timer_e::engine_cells);
+  cells.clear();
+  if (engine.tiles.colored)
+    tile::for_each_colored_cell(engine.tiles, [&](const int x, const int y, const color_t& color) { cells.push_back(cell_t{{x, y}, color}); });
+  else
+    tile::for_each_cell(engine.tiles, [&](const int x, const int y) { cells.push_back(cell_t{{x, y}, white}); });
+}
+
+auto step_hashlife(engine_t& engine, std::vector<cell_t>& cells) -> void {
+  if (!engine.synced) hashlife::load(engine.hashlife, cells);
+  if (!engine.colorless) index_colors(engine, cells);
+
+  hashlife::set_rule(engine.hashlife, engine.rule);
+  hashlife::set_step_exponent(engine.hashlife, engine.step_exponent);
+  {
+    profile::scope_t scope(profile::timer_e::engine_step);
+    hashlife::step(engine.hashlife);
+  }
+
+  profile::scope_t scope(profile::timer_e::engine_cells);
+  cells.clear();
+  if (engine.colorless)
+    hashlife::for_each_cell(engine.hashlife, [&](const int x, const int y) { cells.push_back(cell_t{{x, y}, white}); });
+  else
+    hashlife::for_each_cell(engine.hashlife, [&](const int x, const int y) { cells.push_back(cell_t{{x, y}, resolve_color(engine, x, y)}); });
+}
+
+// the world's buffers were sized up front, only a change of colouring resizes them
+auto step_world(engine_t& engine, std::vector<cell_t>& cells) -> void {
+  world::world_t& world = engine.world;
+  if (!engine.synced) {
+    if (world.colored == engine.colorless) {
+      world.colored = !engine.colorless;
+      world::resize(world, world.topology, world.width, world.height);
+    }
+    world::load(world, cells);
+  }
+
+  {
+    profile::scope_t scope(profile::timer_e::engine_step);
+    world.rule = engine.rule;
+    rule::dispatch(engine.rule, [&]<rule::packed_t packed>() { world::step<packed>(world, engine.pool); });
+  }
+
+  profile::scope_t scope(profile::timer_e::engine_cells);
+  cells.clear();
+  if (world.colored)
+    world::for_each_colored_cell(world, [&](const int x, const int y, const color_t& color) { cells.push_back(cell_t{{x, y}, color}); });
+  else
+    world::for_each_cell(world, [&](const int x, const int y) { cells.push_back(cell_t{{x, y}, white}); });
+}
+
+// the extended neighbourhoods colour their own births
+auto step_ltl(engine_t& engine, std::vector<cell_t>& cells) -> void {
+  if (!engine.synced) {
+    engine.ltl.colored = !engine.colorless;
+    ltl::load(engine.ltl, cells);
+  }
+
+  {
+    profile::scope_t scope(profile::timer_e::engine_step);
+    ltl::step(engine.ltl, engine.pool);
+  }
+
+  profile::scope_t scope(profile::timer_e::engine_cells);
+  cells.clear();
+  if (engine.ltl.colored)
+    ltl::for_each_colored_cell(engine.ltl, [&](const int x, const int y, const color_t& color) { cells.push_back(cell_t{{x, y}, color}); });
+  else
+    ltl::for_each_cell(engine.ltl, [&](const int x, const int y) { cells.push_back(cell_t{{x, y}, white}); });
+}
+
+auto can_jump(const kind_e kind) -> bool { return kind == kind_e::hashlife; }
+
+auto set_step_exponent(engine_t& engine, const int step_exponent) -> void { engine.step_exponent = std::clamp(step_exponent, 0, hashlife::max_level - 3); }
+
+// generations advanced by one step of the selected engine, a remote stepper also covers 2^k
+// generations in one round trip
+auto step_size(const engine_t& engine) -> uint64_t {
+  bool jumps = engine.remote_step != nullptr || (can_jump(engine.kind) && !world::finite(engine.world));
+  return jumps ? uint64_t{1} << engine.step_exponent : 1;
+}
+
+// advances cells by one step of the selected engine, or of the world when it is finite, or of the remote stepper when one is set
+auto step(engine_t& engine, std::vector<cell_t>& cells) -> void {
+  if (engine.remote_step != nullptr) {
+    engine.remote_step(engine, cells, engine.remote);
+  } else if (world::finite(engine.world)) {
+    step_world(engine, cells);
+  } else {
+    switch (engine.kind) {
+      case kind_e::sparse: {
+        profile::scope_t scope(profile::timer_e::engine_step);
+        engine.sparse.colored = !engine.colorless;
+        engine.sparse.rule = engine.rule;
+        rule::dispatch(engine.rule, [&]<rule::packed_t packed>() { sparse::step<packed>(engine.sparse, cells); });
+        break;
+      }
+      case kind_e::tile: step_tiles(engine, cells); break;
+      case kind_e::hashlife: step_hashlife(engine, cells); break;
+      case kind_e::ltl: step_ltl(engine, cells); break;
+    }
+  }
+
+  engine.synced = true;
+  engine.generation += step_size(engine);
+  ++engine.revision;
+}
+
+}  // namespace engine
\ No newline at end of file
@@ -0,0 +1,64 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Engine Cell Types
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+namespace engine {
+
+using color_t = std::array<uint8_t, 3>;
+
+using color_sum_t = std::array<uint16_t, 3>;
+
+// channel sums of a birth's parents, divided by how many there were
+// a birth under B3 always has three parents, and (sum * 21846) >> 16 is sum / 3 for every sum of three channels
+auto third(const uint32_t sum) -> uint8_t { return static_cast<uint8_t>((sum * 21846) >> 16); }
+
+auto blend_colors(const color_sum_t& sum, const int count) -> color_t {
+  if (count == 3) return color_t{third(sum[0]), third(sum[1]), third(sum[2])};
+  if (count == 0) return color_t{255, 255, 255};
+  return color_t{static_cast<uint8_t>(sum[0] / count), static_cast<uint8_t>(sum[1] / count), static_cast<uint8_t>(sum[2] / count)};
+}
+
+auto accumulate_color(color_sum_t& sum, const color_t& color) -> void {
+  sum[0] += color[0];
+  sum[1] += color[1];
+  sum[2] += color[2];
+}
+
+// cells of colourless engines
+static const color_t white{255, 255, 255};
+
+struct cell_t {
+  std::pair<int, int> coord;
+  std::array<uint8_t, 3> color;
+
+  auto operator<=>(const cell_t&) const = default;
+};
+
+// coordinates are packed with their sign bit flipped so that the unsigned
+// ordering of packed keys matches the (x, y) ordering of std::pair<int, int>
+auto pack_coord(const int x, const int y) -> uint64_t {
+  uint64_t packed_x = static_cast<uint32_t>(x) ^ 0x80000000u;
+  uint64_t packed_y = static_cast<uint32_t>(y) ^ 0x80000000u;
+  return (packed_x << 32) | packed_y;
+}
+
+auto pack_coord(const std::pair<int, int>& coord) -> uint64_t { return pack_coord(coord.first, coord.second); }
+
+auto unpack_coord(const uint64_t key) -> std::pair<int, int> {
+  int x = static_cast<int>(static_cast<uint32_t>(key >> 32) ^ 0x80000000u);
+  int y = static_cast<int>(static_cast<uint32_t>(key) ^ 0x80000000u);
+  return std::make_pair(x, y);
+}
+
+static const std::array<std::pair<int, int>, 8> neighbour_deltas{std::make_pair(0, -1), std::make_pair(1, -1), std::make_pair(1, 0),  std::make_pair(1, 1),
+                                                                 std::make_pair(0, 1),  std::make_pair(-1, 1), std::make_pair(-1, 0), std::make_pair(-1, -1)};
+
+}  // namespace engine
\ No newline at end of file
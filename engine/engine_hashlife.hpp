@@ -0,0 +1,485 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Engine HashLife Functions
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <vector>
+
+#include "engine_cell.hpp"
+#include "engine_rule.hpp"
+#include "profile.hpp"
+
+namespace engine::hashlife {
+
+constexpr uint32_t no_node = ~0u;
+
+// the two level 0 nodes are the dead and alive cells
+constexpr uint32_t dead_leaf = 0;
+constexpr uint32_t alive_leaf = 1;
+
+// levels stay small enough for coordinates to fit in 64 bits
+constexpr int max_level = 62;
+
+struct node_t {
+  uint32_t nw, ne, sw, se;
+
+  // successor memoised for the current step exponent
+  uint32_t result{no_node};
+
+  uint8_t level;
+  uint8_t mark{0};
+
+  uint64_t population;
+};
+
+struct hashlife_t {
+  std::vector<node_t> nodes;
+
+  // open addressing table of node indices, hash-consing every node above level 0
+  std::vector<uint32_t> table;
+  size_t table_size{0};
+
+  std::vector<uint32_t> empty_nodes;
+
+  uint32_t root{no_node};
+  int step_exponent{0};
+
+  // memoised results are only valid for the rule they were computed under
+  rule::rule_t rule{rule::conway};
+
+  size_t memory_limit{size_t{512} << 20};
+
+  // nodes that fit in the limit alongside their table and remap slots, a step that would create more is retried
+  size_t max_nodes{0};
+  bool full{false};
+  bool unbounded{false};
+
+  // scratch for collections, kept so that collecting does not allocate
+  std::vector<uint32_t> stack;
+  std::vector<uint32_t> remap;
+
+  uint64_t hits{0};
+  uint64_t misses{0};
+  uint64_t collections{0};
+};
+
+auto hash_children(const uint32_t nw, const uint32_t ne, const uint32_t sw, const uint32_t se) -> uint64_t {
+  uint64_t hash = nw;
+  hash = hash * 0x9E3779B97F4A7C15ull + ne;
+  hash = hash * 0x9E3779B97F4A7C15ull + sw;
+  hash = hash * 0x9E3779B97F4A7C15ull + se;
+  return hash ^ (hash >> 31);
+}
+
+// the store in use, its capacity is reserved up to the limit and kept across collections
+auto memory_usage(const hashlife_t& hashlife) -> size_t {
+  return hashlife.nodes.size() * sizeof(node_t) + (hashlife.table.size() + hashlife.remap.size()) * sizeof(uint32_t);
+}
+
+auto hit_rate(const hashlife_t& hashlife) -> double {
+  uint64_t lookups = hashlife.hits + hashlife.misses;
+  return lookups != 0 ? static_cast<double>(hashlife.hits) / static_cast<double>(lookups) : 0.0;
+}
+
+auto rebuild_table(hashlife_t& hashlife, size_t capacity) -> void {
+  if (capacity > hashlife.table.capacity()) profile::count(profile::counter_e::allocations);
+  hashlife.table.assign(capacity, no_node);
+  size_t mask = capacity - 1;
+  for (uint32_t index = 2; index < hashlife.nodes.size(); ++index) {
+    const node_t& node = hashlife.nodes[index];
+    size_t slot = hash_children(node.nw, node.ne, node.sw, node.se) & mask;
+    while (hashlife.table[slot] != no_node) slot = (slot + 1) & mask;
+    hashlife.table[slot] = index;
+  }
+  hashlife.table_size = hashlife.nodes.size() - 2;
+}
+
+auto create(hashlife_t& hashlife, const uint32_t nw, const uint32_t ne, const uint32_t sw, const uint32_t se) -> uint32_t {
+  if ((hashlife.table_size + 1) * 2 > hashlife.table.size()) rebuild_table(hashlife, std::max<size_t>(hashlife.table.size() * 2, 1024));
+
+  size_t mask = hashlife.table.size() - 1;
+  size_t slot = hash_children(nw, ne, sw, se) & mask;
+  while (hashlife.table[slot] != no_node) {
+    const node_t& node = hashlife.nodes[hashlife.table[slot]];
+    if (node.nw == nw && node.ne == ne && node.sw == sw && node.se == se) return hashlife.table[slot];
+    slot = (slot + 1) & mask;
+  }
+
+  // a full store hands out empty nodes, the step that asked for them is thrown away and retried
+  if (hashlife.nodes.size() >= hashlife.max_nodes && !hashlife.unbounded) {
+    hashlife.full = true;
+    return hashlife.empty_nodes[hashlife.nodes[nw].level + 1];
+  }
+
+  node_t node;
+  node.nw = nw;
+  node.ne = ne;
+  node.sw = sw;
+  node.se = se;
+  node.level = hashlife.nodes[nw].level + 1;
+  node.population = hashlife.nodes[nw].population + hashlife.nodes[ne].population + hashlife.nodes[sw].population + hashlife.nodes[se].population;
+
+  uint32_t index = static_cast<uint32_t>(hashlife.nodes.size());
+  if (hashlife.nodes.size() == hashlife.nodes.capacity()) profile::count(profile::counter_e::allocations);
+  hashlife.nodes.push_back(node);
+  hashlife.table[slot] = index;
+  ++hashlife.table_size;
+  return index;
+}
+
+auto empty(hashlife_t& hashlife, const int level) -> uint32_t {
+  while (static_cast<int>(hashlife.empty_nodes.size()) <= level) {
+    uint32_t below = hashlife.empty_nodes.back();
+    hashlife.empty_nodes.push_back(create(hashlife, below, below, below, below));
+  }
+  return hashlife.empty_nodes[level];
+}
+
+// nodes that fit in the limit next to a table of the given slots, the table is kept at most half full
+// and a collection remaps every node
+auto node_capacity(const size_t memory_limit, const size_t slots) -> size_t {
+  if (slots * sizeof(uint32_t) >= memory_limit) return 0;
+  return std::min(slots / 2, (memory_limit - slots * sizeof(uint32_t)) / (sizeof(node_t) + sizeof(uint32_t)));
+}
+
+// address space for a store at the memory limit is reserved once, the pages are only touched as nodes are
+// created so a store that stays small stays small, and one that reaches the limit never reallocates
+auto reserve_store(hashlife_t& hashlife) -> void {
+  // the largest table that is filled by half as many nodes as it has slots, or one twice the size when it leaves room for more
+  size_t slots = std::bit_floor(std::max<size_t>(hashlife.memory_limit / ((sizeof(node_t) + 3 * sizeof(uint32_t)) / 2), 1));
+  if (node_capacity(hashlife.memory_limit, slots * 2) > node_capacity(hashlife.memory_limit, slots)) slots *= 2;
+  hashlife.max_nodes = node_capacity(hashlife.memory_limit, slots);
+
+  hashlife.nodes.reserve(hashlife.max_nodes);
+  hashlife.table.reserve(slots);
+  hashlife.remap.reserve(hashlife.max_nodes);
+
+  // every node marked pushes at most five nodes a level below it
+  hashlife.stack.reserve(5 * max_level + 1);
+}
+
+auto clear(hashlife_t& hashlife) -> void {
+  reserve_store(hashlife);
+  hashlife.nodes.clear();
+  hashlife.table.clear();
+  hashlife.table_size = 0;
+  hashlife.empty_nodes.clear();
+
+  node_t leaf;
+  leaf.nw = leaf.ne = leaf.sw = leaf.se = no_node;
+  leaf.level = 0;
+
+  leaf.population = 0;
+  hashlife.nodes.push_back(leaf);
+  leaf.population = 1;
+  hashlife.nodes.push_back(leaf);
+
+  // every empty node is built up front so that a full store can still hand them out
+  hashlife.empty_nodes.push_back(dead_leaf);
+  hashlife.unbounded = true;
+  empty(hashlife, max_level);
+  hashlife.unbounded = false;
+  hashlife.full = false;
+  hashlife.root = empty(hashlife, 3);
+}
+
+auto level(const hashlife_t& hashlife, const uint32_t index) -> int { return hashlife.nodes[index].level; }
+
+auto population(const hashlife_t& hashlife) -> uint64_t { return hashlife.root != no_node ? hashlife.nodes[hashlife.root].population : 0; }
+
+// Quadtree Construction ------------------------
+// a node of level n covers [x, x + 2^n) by [y, y + 2^n)
+auto build(hashlife_t& hashlife, std::pair<int, int>* begin, std::pair<int, int>* end, const int level, const int64_t x, const int64_t y) -> uint32_t {
+  if (begin == end) return empty(hashlife, level);
+  if (level == 0) return alive_leaf;
+
+  int64_t half_size = int64_t{1} << (level - 1);
+  int64_t middle_x = x + half_size;
+  int64_t middle_y = y + half_size;
+
+  auto north = std::partition(begin, end, [&](const auto& coord) { return coord.second < middle_y; });
+  auto north_west = std::partition(begin, north, [&](const auto& coord) { return coord.first < middle_x; });
+  auto south_west = std::partition(north, end, [&](const auto& coord) { return coord.first < middle_x; });
+
+  uint32_t nw = build(hashlife, begin, north_west, level - 1, x, y);
+  uint32_t ne = build(hashlife, north_west, north, level - 1, middle_x, y);
+  uint32_t sw = build(hashlife, north, south_west, level - 1, x, middle_y);
+  uint32_t se = build(hashlife, south_west, end, level - 1, middle_x, middle_y);
+  return create(hashlife, nw, ne, sw, se);
+}
+
+// the root of level n is centred on the origin, covering [-2^(n-1), 2^(n-1))
+auto load(hashlife_t& hashlife, const std::vector<cell_t>& cells) -> void {
+  clear(hashlife);
+
+  std::vector<std::pair<int, int>> coords;
+  coords.reserve(cells.size());
+  int64_t extent = 0;
+  for (const auto& [x, y] : cells | std::views::transform(&cell_t::coord)) {
+    coords.emplace_back(x, y);
+    extent = std::max({extent, int64_t{x} + 1, -int64_t{x}, int64_t{y} + 1, -int64_t{y}});
+  }
+
+  int root_level = 3;
+  while ((int64_t{1} << (root_level - 1)) < extent) ++root_level;
+
+  int64_t origin = -(int64_t{1} << (root_level - 1));
+  hashlife.root = build(hashlife, coords.data(), coords.data() + coords.size(), root_level, origin, origin);
+}
+
+template <typename function_t>
+auto for_each_cell(const hashlife_t& hashlife, const uint32_t index, const int64_t x, const int64_t y, function_t& function) -> void {
+  const node_t& node = hashlife.nodes[index];
+  if (node.population == 0) return;
+
+  if (node.level == 0) {
+    if (x < std::numeric_limits<int>::min() || x > std::numeric_limits<int>::max()) return;
+    if (y < std::numeric_limits<int>::min() || y > std::numeric_limits<int>::max()) return;
+    function(static_cast<int>(x), static_cast<int>(y));
+    return;
+  }
+
+  int64_t half_size = int64_t{1} << (node.level - 1);
+  for_each_cell(hashlife, node.nw, x, y, function);
+  for_each_cell(hashlife, node.ne, x + half_size, y, function);
+  for_each_cell(hashlife, node.sw, x, y + half_size, function);
+  for_each_cell(hashlife, node.se, x + half_size, y + half_size, function);
+}
+
+// cells outside the range of int are skipped
+template <typename function_t>
+auto for_each_cell(const hashlife_t& hashlife, function_t&& function) -> void {
+  if (hashlife.root == no_node) return;
+  int64_t origin = -(int64_t{1} << (level(hashlife, hashlife.root) - 1));
+  for_each_cell(hashlife, hashlife.root, origin, origin, function);
+}
+// ----------------------------------------------
+
+// Successor Functions --------------------------
+auto centre(hashlife_t& hashlife, const uint32_t index) -> uint32_t {
+  node_t node = hashlife.nodes[index];
+  return create(hashlife, hashlife.nodes[node.nw].se, hashlife.nodes[node.ne].sw, hashlife.nodes[node.sw].ne, hashlife.nodes[node.se].nw);
+}
+
+// one generation of the centre 2x2 of a level 2 node
+auto successor_base(hashlife_t& hashlife, const uint32_t index) -> uint32_t {
+  node_t node = hashlife.nodes[index];
+
+  // 4x4 bits, bit (y * 4 + x)
+  uint32_t bits = 0;
+  auto place = [&](const uint32_t quadrant, const int offset_x, const int offset_y) {
+    const node_t& child = hashlife.nodes[quadrant];
+    bits |= child.nw << ((offset_y + 0) * 4 + offset_x + 0);
+    bits |= child.ne << ((offset_y + 0) * 4 + offset_x + 1);
+    bits |= child.sw << ((offset_y + 1) * 4 + offset_x + 0);
+    bits |= child.se << ((offset_y + 1) * 4 + offset_x + 1);
+  };
+  place(node.nw, 0, 0);
+  place(node.ne, 2, 0);
+  place(node.sw, 0, 2);
+  place(node.se, 2, 2);
+
+  std::array<uint32_t, 4> next;
+  for (int cell = 0; cell < 4; ++cell) {
+    int x = 1 + (cell & 1);
+    int y = 1 + (cell >> 1);
+    int count = 0;
+    for (const auto& [delta_x, delta_y] : neighbour_deltas) count += (bits >> ((y + delta_y) * 4 + x + delta_x)) & 1;
+    bool alive = (bits >> (y * 4 + x)) & 1;
+    next[cell] = (alive ? rule::survives(hashlife.rule, count) : rule::born(hashlife.rule, count)) ? alive_leaf : dead_leaf;
+  }
+  return create(hashlife, next[0], next[1], next[2], next[3]);
+}
+
+// the centre half of a level n node advanced by 2^min(step_exponent, n - 2) generations
+auto successor(hashlife_t& hashlife, const uint32_t index) -> uint32_t {
+  node_t node = hashlife.nodes[index];
+  if (node.population == 0) return empty(hashlife, node.level - 1);
+
+  if (node.result != no_node) {
+    ++hashlife.hits;
+    return node.result;
+  }
+  ++hashlife.misses;
+
+  uint32_t result;
+  if (node.level == 2) {
+    result = successor_base(hashlife, index);
+  } else {
+    node_t nw = hashlife.nodes[node.nw];
+    node_t ne = hashlife.nodes[node.ne];
+    node_t sw = hashlife.nodes[node.sw];
+    node_t se = hashlife.nodes[node.se];
+
+    // the nine overlapping sub-squares of half the size
+    std::array<uint32_t, 9> squares{
+        node.nw, create(hashlife, nw.ne, ne.nw, nw.se, ne.sw), node.ne,
+        create(hashlife, nw.sw, nw.se, sw.nw, sw.ne), create(hashlife, nw.se, ne.sw, sw.ne, se.nw), create(hashlife, ne.sw, ne.se, se.nw, se.ne),
+        node.sw, create(hashlife, sw.ne, se.nw, sw.se, se.sw), node.se,
+    };
+    for (auto& square : squares) square = successor(hashlife, square);
+
+    bool full_step = hashlife.step_exponent >= node.level - 2;
+    auto combine = [&](const int a, const int b, const int c, const int d) -> uint32_t {
+      uint32_t quarter = create(hashlife, squares[a], squares[b], squares[c], squares[d]);
+      return full_step ? successor(hashlife, quarter) : centre(hashlife, quarter);
+    };
+
+    uint32_t result_nw = combine(0, 1, 3, 4);
+    uint32_t result_ne = combine(1, 2, 4, 5);
+    uint32_t result_sw = combine(3, 4, 6, 7);
+    uint32_t result_se = combine(4, 5, 7, 8);
+    result = create(hashlife, result_nw, result_ne, result_sw, result_se);
+  }
+
+  // results built from the empty nodes of a full store are wrong
+  if (!hashlife.full) hashlife.nodes[index].result = result;
+  return result;
+}
+// ----------------------------------------------
+
+// Garbage Collection ---------------------------
+auto mark(hashlife_t& hashlife, const uint32_t root, const bool keep_results) -> void {
+  auto& stack = hashlife.stack;
+  stack.assign(1, root);
+  while (!stack.empty()) {
+    uint32_t index = stack.back();
+    stack.pop_back();
+
+    node_t& node = hashlife.nodes[index];
+    if (node.mark || node.level == 0) continue;
+    node.mark = 1;
+
+    stack.push_back(node.nw);
+    stack.push_back(node.ne);
+    stack.push_back(node.sw);
+    stack.push_back(node.se);
+    if (keep_results && node.result != no_node) stack.push_back(node.result);
+  }
+}
+
+// drops every node unreachable from the root, children always precede their parents
+auto collect(hashlife_t& hashlife, const bool keep_results) -> void {
+  mark(hashlife, hashlife.root, keep_results);
+  for (const auto empty_node : hashlife.empty_nodes) mark(hashlife, empty_node, false);
+
+  auto& remap = hashlife.remap;
+  remap.assign(hashlife.nodes.size(), no_node);
+  remap[dead_leaf] = dead_leaf;
+  remap[alive_leaf] = alive_leaf;
+
+  uint32_t kept = 2;
+  for (uint32_t index = 2; index < hashlife.nodes.size(); ++index) {
+    node_t node = hashlife.nodes[index];
+    if (!node.mark) continue;
+
+    node.mark = 0;
+    node.nw = remap[node.nw];
+    node.ne = remap[node.ne];
+    node.sw = remap[node.sw];
+    node.se = remap[node.se];
+    remap[index] = kept;
+    hashlife.nodes[kept++] = node;
+  }
+  hashlife.nodes.resize(kept);
+
+  for (auto& node : hashlife.nodes) {
+    if (node.result == no_node) continue;
+    node.result = keep_results ? remap[node.result] : no_node;
+  }
+  for (auto& empty_node : hashlife.empty_nodes) empty_node = remap[empty_node];
+  hashlife.root = remap[hashlife.root];
+
+  size_t capacity = 1024;
+  while (capacity < hashlife.nodes.size() * 2) capacity <<= 1;
+  rebuild_table(hashlife, capacity);
+  ++hashlife.collections;
+}
+
+// leaves room for the next step once the store is three quarters full, forgetting memoised results only when it must
+auto collect_garbage(hashlife_t& hashlife) -> void {
+  if (hashlife.nodes.size() * 4 <= hashlife.max_nodes * 3) return;
+
+  collect(hashlife, true);
+  if (hashlife.nodes.size() * 2 > hashlife.max_nodes) collect(hashlife, false);
+}
+// ----------------------------------------------
+
+auto expand(hashlife_t& hashlife, const uint32_t index) -> uint32_t {
+  node_t node = hashlife.nodes[index];
+  uint32_t border = empty(hashlife, node.level - 1);
+  uint32_t nw = create(hashlife, border, border, border, node.nw);
+  uint32_t ne = create(hashlife, border, border, node.ne, border);
+  uint32_t sw = create(hashlife, border, node.sw, border, border);
+  uint32_t se = create(hashlife, node.se, border, border, border);
+  return create(hashlife, nw, ne, sw, se);
+}
+
+// true when every live cell lies in the centre quarter of the node
+auto padded(hashlife_t& hashlife, const uint32_t index) -> bool {
+  node_t node = hashlife.nodes[index];
+  if (node.level < 3) return false;
+  uint32_t inner = centre(hashlife, centre(hashlife, index));
+  return hashlife.nodes[inner].population == node.population;
+}
+
+auto set_step_exponent(hashlife_t& hashlife, const int step_exponent) -> void {
+  if (step_exponent == hashlife.step_exponent) return;
+  hashlife.step_exponent = step_exponent;
+  for (auto& node : hashlife.nodes) node.result = no_node;
+}
+
+auto set_rule(hashlife_t& hashlife, const rule::rule_t rule) -> void {
+  if (rule == hashlife.rule) return;
+  hashlife.rule = rule;
+  for (auto& node : hashlife.nodes) node.result = no_node;
+}
+
+// advances the universe by 2^exponent generations, a jump that fills the store is retried after a collection
+// that keeps only the root, then as two jumps of half the size, and a single generation may pass the limit
+auto jump(hashlife_t& hashlife, const int exponent) -> void {
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    set_step_exponent(hashlife, exponent);
+    hashlife.unbounded = exponent == 0 && attempt == 1;
+
+    uint32_t root = hashlife.root;
+    uint32_t next = root;
+    while (level(hashlife, next) < exponent + 3 || !padded(hashlife, next)) {
+      if (level(hashlife, next) >= max_level) break;
+      next = expand(hashlife, next);
+    }
+    next = successor(hashlife, next);
+
+    hashlife.unbounded = false;
+    if (!hashlife.full) {
+      hashlife.root = next;
+      return;
+    }
+    hashlife.full = false;
+    hashlife.root = root;
+    collect(hashlife, false);
+  }
+
+  jump(hashlife, exponent - 1);
+  jump(hashlife, exponent - 1);
+}
+
+// advances the universe by 2^step_exponent generations
+auto step(hashlife_t& hashlife) -> void {
+  int step_exponent = hashlife.step_exponent;
+  jump(hashlife, step_exponent);
+  set_step_exponent(hashlife, step_exponent);
+
+  collect_garbage(hashlife);
+}
+
+}  // namespace engine::hashlife
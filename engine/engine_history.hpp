@@ -0,0 +1,377 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Engine History Functions
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "engine_cell.hpp"
+#include "engine_sparse.hpp"
+
+namespace engine::history {
+
+// every step is recorded as the cells it gave birth to and the cells it killed, with a keyframe
+// holding the whole board now and then so that reaching back a long way never replays more than
+// a keyframe's worth of changes, the records live in a fixed arena and the oldest are dropped,
+// a keyframe and the changes that follow it at a time, when a new one does not fit
+struct record_t {
+  uint64_t generation;
+  size_t offset;
+  size_t size;
+  bool keyframe;
+};
+
+// mark flips every recorded step, cells that keep the previous mark were not seen and have died
+struct entry_t {
+  color_t color;
+  uint8_t mark;
+};
+
+using change_t = std::pair<uint64_t, color_t>;
+
+// past this many steps a keyframe is taken however small the changes are
+constexpr size_t max_changes = 256;
+
+struct history_t {
+  // zero records nothing
+  size_t capacity{0};
+  std::unique_ptr<uint8_t[]> arena;
+  size_t end{0};
+
+  // a ring of records, oldest first
+  std::vector<record_t> records;
+  size_t first{0};
+  size_t count{0};
+
+  // the board as of the newest record, false when the cells have been edited since
+  sparse::table_t<entry_t> cells;
+  uint8_t mark{0};
+  bool synced{false};
+  bool colored{true};
+
+  // bytes of the newest keyframe and of the changes recorded after it
+  size_t keyframe_size{0};
+  size_t change_size{0};
+  size_t changes{0};
+
+  // the changes of the last record, and the whole board a keyframe is built from apart from them
+  std::vector<change_t> births;
+  std::vector<change_t> deaths;
+  std::vector<change_t> whole;
+  std::vector<uint8_t> encoded;
+};
+
+// the births and deaths of the last step the history diffed, which took the engine's cells from
+// revision from to revision to, so anything else following the board need not diff it again
+struct delta_t {
+  uint64_t from;
+  uint64_t to;
+  const std::vector<change_t>* births;
+  const std::vector<change_t>* deaths;
+};
+
+auto enabled(const history_t& history) -> bool { return history.capacity > 0; }
+
+auto at(history_t& history, const size_t index) -> record_t& { return history.records[(history.first + index) % history.records.size()]; }
+auto at(const history_t& history, const size_t index) -> const record_t& { return history.records[(history.first + index) % history.records.size()]; }
+
+auto reset(history_t& history) -> void {
+  history.first = 0;
+  history.count = 0;
+  history.end = 0;
+  history.synced = false;
+}
+
+// the arena is allocated once and left uninitialised, so the pages it never reaches are never touched
+auto set_capacity(history_t& history, const size_t capacity) -> void {
+  history.capacity = capacity;
+  history.arena = std::make_unique_for_overwrite<uint8_t[]>(capacity);
+  history.records.assign(1024, record_t{});
+  reset(history);
+}
+
+auto memory_usage(const history_t& history) -> size_t {
+  if (history.count == 0) return 0;
+  size_t begin = at(history, 0).offset;
+  return history.end > begin ? history.end - begin : history.capacity - begin + history.end;
+}
+
+auto oldest_generation(const history_t& history) -> uint64_t { return history.count > 0 ? at(history, 0).generation : 0; }
+
+// Encoding Functions ---------------------------
+// a record is the birth and death counts, the sorted keys of each as varint deltas and then
+// the colours of the births followed by those of the deaths
+auto put(std::vector<uint8_t>& bytes, uint64_t value) -> void {
+  while (value >= 0x80) {
+    bytes.push_back(static_cast<uint8_t>(value) | 0x80);
+    value >>= 7;
+  }
+  bytes.push_back(static_cast<uint8_t>(value));
+}
+
+// false when the bytes run out before the value does
+auto get(const uint8_t*& data, const uint8_t* end, uint64_t& value) -> bool {
+  value = 0;
+  for (int shift = 0; data != end && shift < 64; shift += 7) {
+    uint8_t byte = *data++;
+    value |= uint64_t{byte & 0x7fu} << shift;
+    if (byte < 0x80) return true;
+  }
+  return false;
+}
+
+// also the wire format of the live publisher, so it takes any lists of changes
+auto encode(const std::vector<change_t>& births, const std::vector<change_t>& deaths, const bool colored, std::vector<uint8_t>& bytes) -> void {
+  bytes.clear();
+  put(bytes, births.size());
+  put(bytes, deaths.size());
+  for (const auto* changes : {&births, &deaths}) {
+    uint64_t previous = 0;
+    for (const auto& [key, color] : *changes) {
+      put(bytes, key - previous);
+      previous = key;
+    }
+  }
+  if (!colored) return;
+  for (const auto* changes : {&births, &deaths})
+    for (const auto& [key, color] : *changes) bytes.insert(std::end(bytes), std::begin(color), std::end(color));
+}
+
+// checks every count and key against the bytes, they may have come over the network
+auto decode(const uint8_t* data, const size_t size, const bool colored, std::vector<change_t>& births, std::vector<change_t>& deaths) -> bool {
+  const uint8_t* end = data + size;
+  uint64_t birth_count, death_count;
+  if (!get(data, end, birth_count) || !get(data, end, death_count) || birth_count + death_count > size) return false;
+  births.resize(birth_count);
+  deaths.resize(death_count);
+  for (auto* changes : {&births, &deaths}) {
+    uint64_t key = 0;
+    for (auto& change : *changes) {
+      uint64_t delta;
+      if (!get(data, end, delta)) return false;
+      key += delta;
+      change = change_t{key, white};
+    }
+  }
+  if (!colored) return data == end;
+  if (static_cast<size_t>(end - data) != (birth_count + death_count) * 3) return false;
+  for (auto* changes : {&births, &deaths}) {
+    for (auto& change : *changes) {
+      std::copy_n(data, 3, std::begin(change.second));
+      data += 3;
+    }
+  }
+  return true;
+}
+
+auto encode(history_t& history) -> void { encode(history.births, history.deaths, history.colored, history.encoded); }
+
+auto decode(history_t& history, const record_t& record) -> void { decode(history.arena.get() + record.offset, record.size, history.colored, history.births, history.deaths); }
+// ----------------------------------------------
+
+// Board Functions ------------------------------
+auto load(history_t& history, const std::vector<cell_t>& cells) -> void {
+  sparse::clear(history.cells);
+  sparse::reserve(history.cells, cells.size());
+  for (const auto& cell : cells) *sparse::insert(history.cells, pack_coord(cell.coord)).first = entry_t{cell.color, history.mark};
+}
+
+auto add(history_t& history, const change_t& change) -> void { *sparse::insert(history.cells, change.first).first = entry_t{change.second, history.mark}; }
+
+// removes the deaths and adds the births
+auto apply(history_t& history, const std::vector<change_t>& births, const std::vector<change_t>& deaths) -> void {
+  for (const auto& change : deaths) sparse::erase(history.cells, change.first);
+  for (const auto& change : births) add(history, change);
+}
+
+// forwards removes the deaths and adds the births, backwards undoes that
+auto apply(history_t& history, const record_t& record, const bool forwards) -> void {
+  decode(history, record);
+  if (forwards)
+    apply(history, history.births, history.deaths);
+  else
+    apply(history, history.deaths, history.births);
+}
+
+// fills births and deaths with what changed between the recorded board and cells, and records cells
+auto diff(history_t& history, const std::vector<cell_t>& cells) -> void {
+  history.births.clear();
+  history.deaths.clear();
+  history.mark ^= 1;
+
+  auto& table = history.cells;
+  sparse::reserve(table, cells.size());
+  for (const auto& cell : cells) {
+    uint64_t key = pack_coord(cell.coord);
+    auto [entry, inserted] = sparse::insert(table, key);
+    if (inserted) {
+      history.births.emplace_back(key, cell.color);
+    } else if (entry->mark != history.mark && entry->color != cell.color) {
+      history.deaths.emplace_back(key, entry->color);
+      history.births.emplace_back(key, cell.color);
+    }
+    *entry = entry_t{cell.color, history.mark};
+  }
+
+  for (size_t slot = 0; slot < table.used.size(); ++slot)
+    if (table.used[slot] && table.values[slot].mark != history.mark) history.deaths.emplace_back(table.keys[slot], table.values[slot].color);
+  for (const auto& [key, color] : history.deaths)
+    if (sparse::find(table, key)->mark != history.mark) sparse::erase(table, key);
+
+  std::ranges::sort(history.births, {}, &change_t::first);
+  std::ranges::sort(history.deaths, {}, &change_t::first);
+}
+// ----------------------------------------------
+
+// Record Functions -----------------------------
+// drops the oldest keyframe and its changes, false when it is the only keyframe left
+auto drop_oldest(history_t& history) -> bool {
+  size_t next = 1;
+  while (next < history.count && !at(history, next).keyframe) ++next;
+  if (next == history.count) return false;
+  history.first = (history.first + next) % history.records.size();
+  history.count -= next;
+  return true;
+}
+
+auto grow_records(history_t& history) -> void {
+  std::ranges::rotate(history.records, std::begin(history.records) + history.first);
+  history.first = 0;
+  history.records.resize(history.records.size() * 2);
+}
+
+// copies the encoded record into the arena, false when it had to drop every record to make room
+auto store(history_t& history, const uint64_t generation, const bool keyframe) -> bool {
+  size_t size = history.encoded.size();
+  if (size > history.capacity) {
+    reset(history);
+    return false;
+  }
+
+  size_t offset = 0;
+  while (history.count > 0) {
+    size_t begin = at(history, 0).offset;
+    if (history.end > begin && history.end + size <= history.capacity) {
+      offset = history.end;
+      break;
+    }
+    if (history.end > begin && size <= begin) break;
+    if (history.end <= begin && history.end + size <= begin) {
+      offset = history.end;
+      break;
+    }
+    if (!drop_oldest(history)) {
+      reset(history);
+      if (!keyframe) return false;
+    }
+  }
+
+  if (history.count == history.records.size()) grow_records(history);
+  std::ranges::copy(history.encoded, history.arena.get() + offset);
+  at(history, history.count++) = record_t{generation, offset, size, keyframe};
+  history.end = offset + size;
+  return true;
+}
+
+// leaves births and deaths alone, they may still be wanted as the step's changes
+auto store_keyframe(history_t& history, const uint64_t generation) -> void {
+  auto& whole = history.whole;
+  whole.clear();
+  const auto& table = history.cells;
+  for (size_t slot = 0; slot < table.used.size(); ++slot)
+    if (table.used[slot]) whole.emplace_back(table.keys[slot], table.values[slot].color);
+  std::ranges::sort(whole, {}, &change_t::first);
+  encode(whole, {}, history.colored, history.encoded);
+
+  history.synced = store(history, generation, true);
+  history.keyframe_size = history.encoded.size();
+  history.change_size = 0;
+  history.changes = 0;
+}
+
+// records the board a step is about to start from, when it was edited since the last record
+auto prepare(history_t& history, const std::vector<cell_t>& cells, const uint64_t generation, const bool colored) -> void {
+  if (!enabled(history) || (history.synced && history.colored == colored)) return;
+  if (history.colored != colored) reset(history);
+  history.colored = colored;
+  load(history, cells);
+  store_keyframe(history, generation);
+}
+
+// records the board a step produced, as its changes or as a keyframe once the changes since the
+// last one outweigh it, true when births and deaths hold the step's changes
+auto record(history_t& history, const std::vector<cell_t>& cells, const uint64_t generation, const bool colored) -> bool {
+  if (!enabled(history)) return false;
+  if (!history.synced || history.colored != colored || history.count == 0) {
+    prepare(history, cells, generation, colored);
+    return false;
+  }
+
+  diff(history, cells);
+  encode(history);
+  bool due = history.change_size + history.encoded.size() >= history.keyframe_size || history.changes >= max_changes;
+  if (!due && store(history, generation, false)) {
+    history.change_size += history.encoded.size();
+    ++history.changes;
+    return true;
+  }
+  store_keyframe(history, generation);
+  return true;
+}
+// ----------------------------------------------
+
+// Rewind Functions -----------------------------
+// moves cells back to the newest record at or before generation - generations, or the oldest one,
+// replaying forwards from a keyframe or undoing backwards from the newest record, whichever reads
+// fewer bytes, and forgets every record after it
+auto rewind(history_t& history, const uint64_t generations, std::vector<cell_t>& cells, uint64_t& generation) -> bool {
+  if (history.count == 0) return false;
+  uint64_t target_generation = generation > generations ? generation - generations : 0;
+
+  size_t target = 0;
+  while (target + 1 < history.count && at(history, target + 1).generation <= target_generation) ++target;
+
+  size_t keyframe = target;
+  while (!at(history, keyframe).keyframe) --keyframe;
+
+  size_t forwards_size = 0;
+  for (size_t index = keyframe; index <= target; ++index) forwards_size += at(history, index).size;
+  size_t backwards_size = 0;
+  bool backwards = true;
+  for (size_t index = target + 1; index < history.count; ++index) {
+    backwards_size += at(history, index).size;
+    backwards = backwards && !at(history, index).keyframe;
+  }
+
+  if (backwards && backwards_size <= forwards_size) {
+    for (size_t index = history.count; index-- > target + 1;) apply(history, at(history, index), false);
+  } else {
+    sparse::clear(history.cells);
+    for (size_t index = keyframe; index <= target; ++index) apply(history, at(history, index), true);
+  }
+
+  const record_t& record = at(history, target);
+  history.count = target + 1;
+  history.end = record.offset + record.size;
+  history.keyframe_size = at(history, keyframe).size;
+  history.change_size = forwards_size - history.keyframe_size;
+  history.changes = target - keyframe;
+  history.synced = true;
+
+  cells.clear();
+  const auto& table = history.cells;
+  for (size_t slot = 0; slot < table.used.size(); ++slot)
+    if (table.used[slot]) cells.push_back(cell_t{unpack_coord(table.keys[slot]), table.values[slot].color});
+  generation = record.generation;
+  return true;
+}
+// ----------------------------------------------
+
+}  // namespace engine::history
@@ -0,0 +1,117 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Engine Index Functions
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "engine_cell.hpp"
+#include "engine_sparse.hpp"
+
+namespace engine::index {
+
+// cells bucketed into 32x32 chunks, rebuilt only when the cells change
+constexpr int chunk_shift = 5;
+
+// the colour sums let a zoomed out view take a whole chunk at once
+struct chunk_t {
+  int x;
+  int y;
+  uint32_t begin;
+  uint32_t end;
+  std::array<uint64_t, 3> color_sum;
+};
+
+struct index_t {
+  sparse::table_t<uint32_t> lookup;
+  std::vector<chunk_t> chunks;
+
+  // cell indices ordered by chunk, chunk_t::begin and end delimit them
+  std::vector<uint32_t> order;
+  std::vector<uint32_t> cell_chunks;
+
+  // the engine revision the index was built from
+  uint64_t revision{~uint64_t{0}};
+};
+
+// a counting sort by chunk, all storage is kept between builds
+auto build(index_t& index, const std::vector<cell_t>& cells, const uint64_t revision) -> void {
+  sparse::clear(index.lookup);
+  sparse::reserve(index.lookup, cells.size() >> 4);
+  index.chunks.clear();
+  index.cell_chunks.resize(cells.size());
+
+  for (size_t cell = 0; cell < cells.size(); ++cell) {
+    int chunk_x = cells[cell].coord.first >> chunk_shift;
+    int chunk_y = cells[cell].coord.second >> chunk_shift;
+    auto [chunk, inserted] = sparse::insert(index.lookup, pack_coord(chunk_x, chunk_y));
+    if (inserted) {
+      *chunk = static_cast<uint32_t>(index.chunks.size());
+      index.chunks.push_back(chunk_t{chunk_x, chunk_y, 0, 0, {0, 0, 0}});
+    }
+    chunk_t& counted = index.chunks[*chunk];
+    ++counted.end;
+    for (int channel = 0; channel < 3; ++channel) counted.color_sum[channel] += cells[cell].color[channel];
+    index.cell_chunks[cell] = *chunk;
+  }
+
+  uint32_t begin = 0;
+  for (auto& chunk : index.chunks) {
+    chunk.begin = begin;
+    begin += chunk.end;
+    chunk.end = chunk.begin;
+  }
+
+  index.order.resize(cells.size());
+  for (size_t cell = 0; cell < cells.size(); ++cell) index.order[index.chunks[index.cell_chunks[cell]].end++] = static_cast<uint32_t>(cell);
+
+  index.revision = revision;
+}
+
+// calls function(chunk) for every chunk overlapping the inclusive coordinate rectangle
+template <typename function_t>
+auto query_chunks(const index_t& index, const int min_x, const int min_y, const int max_x, const int max_y, function_t&& function) -> void {
+  int min_chunk_x = min_x >> chunk_shift;
+  int min_chunk_y = min_y >> chunk_shift;
+  int max_chunk_x = max_x >> chunk_shift;
+  int max_chunk_y = max_y >> chunk_shift;
+
+  // look the visible chunks up when there are fewer of them than occupied chunks
+  uint64_t visible = (uint64_t(int64_t{max_chunk_x} - min_chunk_x) + 1) * (uint64_t(int64_t{max_chunk_y} - min_chunk_y) + 1);
+  if (visible <= index.chunks.size()) {
+    for (int chunk_y = min_chunk_y; chunk_y <= max_chunk_y; ++chunk_y) {
+      for (int chunk_x = min_chunk_x; chunk_x <= max_chunk_x; ++chunk_x) {
+        if (const uint32_t* chunk = sparse::find(index.lookup, pack_coord(chunk_x, chunk_y))) function(index.chunks[*chunk]);
+      }
+    }
+    return;
+  }
+
+  for (const auto& chunk : index.chunks) {
+    if (chunk.x >= min_chunk_x && chunk.x <= max_chunk_x && chunk.y >= min_chunk_y && chunk.y <= max_chunk_y) function(chunk);
+  }
+}
+
+// calls function(cell) for every cell inside the inclusive coordinate rectangle
+template <typename function_t>
+auto query(const index_t& index, const std::vector<cell_t>& cells, const int min_x, const int min_y, const int max_x, const int max_y, function_t&& function) -> void {
+  query_chunks(index, min_x, min_y, max_x, max_y, [&](const chunk_t& chunk) {
+    for (uint32_t position = chunk.begin; position < chunk.end; ++position) {
+      const cell_t& cell = cells[index.order[position]];
+      const auto& [x, y] = cell.coord;
+      if (x >= min_x && x <= max_x && y >= min_y && y <= max_y) function(cell);
+    }
+  });
+}
+
+auto contains(const index_t& index, const std::vector<cell_t>& cells, const int x, const int y) -> bool {
+  bool found = false;
+  query(index, cells, x, y, x, y, [&found](const cell_t&) { found = true; });
+  return found;
+}
+
+}  // namespace engine::index
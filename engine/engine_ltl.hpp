@@ -0,0 +1,397 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Engine Larger than Life Functions
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "engine_cell.hpp"
+#include "engine_pool.hpp"
+#include "engine_sparse.hpp"
+#include "engine_tile.hpp"
+#include "profile.hpp"
+
+namespace engine::ltl {
+
+// Rule Functions -------------------------------
+enum struct neighbourhood_e : uint8_t { moore, von_neumann };
+
+// counts cover every cell within radius of the centre, the centre itself only when middle is set
+struct rule_t {
+  int radius;
+  bool middle;
+  int survival_min, survival_max;
+  int birth_min, birth_max;
+  neighbourhood_e neighbourhood;
+
+  auto operator<=>(const rule_t&) const = default;
+};
+
+// the halo has to fit inside the neighbouring tiles
+constexpr int max_radius = 16;
+
+constexpr rule_t bosco{5, true, 34, 58, 34, 45, neighbourhood_e::moore};
+
+// parses golly's R5,C0,M1,S34..58,B34..45,NM, only two state rules are supported
+// and births must need at least one live neighbour
+auto parse(std::string_view text, rule_t& rule) -> bool {
+  rule_t parsed{0, false, 0, 0, 0, 0, neighbourhood_e::moore};
+  bool seen_radius = false, seen_survival = false, seen_birth = false;
+
+  auto number = [](std::string_view digits, int& value) -> bool {
+    auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), value);
+    return error == std::errc() && end == digits.data() + digits.size();
+  };
+  auto range = [&](std::string_view field, int& min, int& max) -> bool {
+    auto dots = field.find("..");
+    if (dots == std::string_view::npos) return number(field, min) && number(field, max);
+    return number(field.substr(0, dots), min) && number(field.substr(dots + 2), max);
+  };
+
+  while (!text.empty()) {
+    auto comma = text.find(',');
+    std::string_view field = text.substr(0, comma);
+    text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+    if (field.empty()) return false;
+
+    std::string_view value = field.substr(1);
+    int states = 0, middle = 0;
+    switch (field[0]) {
+      case 'R': seen_radius = number(value, parsed.radius); break;
+      case 'C':
+        if (!number(value, states) || states > 2) return false;
+        break;
+      case 'M':
+        if (!number(value, middle) || middle > 1) return false;
+        parsed.middle = middle == 1;
+        break;
+      case 'S': seen_survival = range(value, parsed.survival_min, parsed.survival_max); break;
+      case 'B': seen_birth = range(value, parsed.birth_min, parsed.birth_max); break;
+      case 'N':
+        if (value == "M")
+          parsed.neighbourhood = neighbourhood_e::moore;
+        else if (value == "N")
+          parsed.neighbourhood = neighbourhood_e::von_neumann;
+        else
+          return false;
+        break;
+      default: return false;
+    }
+  }
+
+  if (!seen_radius || !seen_survival || !seen_birth) return false;
+  if (parsed.radius < 1 || parsed.radius > max_radius || parsed.birth_min < 1) return false;
+  rule = parsed;
+  return true;
+}
+
+auto format(const rule_t& rule) -> std::string {
+  return "R" + std::to_string(rule.radius) + ",C0,M" + (rule.middle ? "1" : "0") + ",S" + std::to_string(rule.survival_min) + ".." + std::to_string(rule.survival_max) + ",B" + std::to_string(rule.birth_min) + ".." +
+         std::to_string(rule.birth_max) + ",N" + (rule.neighbourhood == neighbourhood_e::moore ? "M" : "N");
+}
+// ----------------------------------------------
+
+using tile::rows_t;
+using tile::tile_mask;
+using tile::tile_shift;
+using tile::tile_size;
+
+using plane_t = std::array<tile::channel_t, 3>;
+
+struct tile_t {
+  int x, y;
+  rows_t rows;
+};
+
+// only tiles holding live cells are kept, each generation steps them and their eight neighbours
+struct ltl_t {
+  rule_t rule{bosco};
+  bool colored{true};
+
+  std::vector<tile_t> tiles;
+  std::vector<plane_t> planes;
+  sparse::table_t<uint32_t> index;
+
+  // the tiles stepped this generation and what they became, swapped in afterwards
+  sparse::table_t<uint8_t> seen;
+  std::vector<std::pair<int, int>> active;
+  std::vector<tile_t> next_tiles;
+  std::vector<plane_t> next_planes;
+};
+
+auto clear(ltl_t& ltl) -> void {
+  ltl.tiles.clear();
+  ltl.planes.clear();
+  sparse::clear(ltl.index);
+}
+
+auto find_tile(ltl_t& ltl, const int tile_x, const int tile_y) -> const tile_t* {
+  auto found = sparse::find(ltl.index, tile::tile_key(tile_x, tile_y));
+  return found != nullptr ? &ltl.tiles[*found] : nullptr;
+}
+
+auto set_cell(ltl_t& ltl, const int x, const int y, const color_t& color) -> void {
+  auto [found, inserted] = sparse::insert(ltl.index, tile::tile_key(x >> tile_shift, y >> tile_shift));
+  if (inserted) {
+    *found = static_cast<uint32_t>(ltl.tiles.size());
+    ltl.tiles.push_back(tile_t{x >> tile_shift, y >> tile_shift, {}});
+    if (ltl.colored) ltl.planes.emplace_back();
+  }
+
+  ltl.tiles[*found].rows[y & tile_mask] |= uint64_t{1} << (x & tile_mask);
+  if (!ltl.colored) return;
+  for (int channel = 0; channel < 3; ++channel) ltl.planes[*found][channel][(y & tile_mask) * tile_size + (x & tile_mask)] = color[channel];
+}
+
+auto load(ltl_t& ltl, const std::vector<cell_t>& cells) -> void {
+  clear(ltl);
+  for (const auto& cell : cells) set_cell(ltl, cell.coord.first, cell.coord.second, cell.color);
+}
+
+template <typename function_t>
+auto for_each_cell(const ltl_t& ltl, function_t&& function) -> void {
+  for (const auto& tile : ltl.tiles) {
+    for (int row = 0; row < tile_size; ++row) {
+      for (uint64_t word = tile.rows[row]; word != 0; word &= word - 1) function((tile.x << tile_shift) + std::countr_zero(word), (tile.y << tile_shift) + row);
+    }
+  }
+}
+
+template <typename function_t>
+auto for_each_colored_cell(const ltl_t& ltl, function_t&& function) -> void {
+  for (size_t index = 0; index < ltl.tiles.size(); ++index) {
+    const auto& tile = ltl.tiles[index];
+    const auto& channels = ltl.planes[index];
+    for (int row = 0; row < tile_size; ++row) {
+      for (uint64_t word = tile.rows[row]; word != 0; word &= word - 1) {
+        int column = std::countr_zero(word);
+        int cell = row * tile_size + column;
+        function((tile.x << tile_shift) + column, (tile.y << tile_shift) + row, color_t{channels[0][cell], channels[1][cell], channels[2][cell]});
+      }
+    }
+  }
+}
+
+// Neighbourhood Functions ----------------------
+// a tile is stepped from a domain of itself plus a margin of radius + 2 cells, every table
+// is indexed [v * side + u] where domain cell (u, v) is tile cell (u - margin, v - margin)
+struct workspace_t {
+  int margin{0};
+  int side{0};
+
+  std::vector<int32_t> values;
+  std::vector<int32_t> prefix;
+  std::vector<int32_t> diagonal;
+  std::vector<int32_t> antidiagonal;
+
+  std::array<int32_t, tile_size * tile_size> counts;
+  std::array<std::array<int32_t, tile_size * tile_size>, 3> sums;
+};
+
+auto prepare(workspace_t& workspace, const int radius) -> void {
+  workspace.margin = radius + 2;
+  workspace.side = tile_size + 2 * workspace.margin;
+  size_t area = static_cast<size_t>(workspace.side) * workspace.side;
+  workspace.values.resize(area);
+  workspace.prefix.resize(area);
+  workspace.diagonal.resize(area);
+  workspace.antidiagonal.resize(area);
+}
+
+// the neighbourhood sum of workspace.values around every tile cell, centre included, in O(1) per cell whatever the radius
+// moore boxes come from a summed-area table, von neumann diamonds from row prefix sums accumulated along both diagonals
+auto neighbourhood_sums(workspace_t& workspace, const rule_t& rule, std::array<int32_t, tile_size * tile_size>& out) -> void {
+  const int side = workspace.side;
+  const int margin = workspace.margin;
+  const int r = rule.radius;
+  auto at = [side](std::vector<int32_t>& table, const int u, const int v) -> int32_t& { return table[static_cast<size_t>(v) * side + u]; };
+
+  if (rule.neighbourhood == neighbourhood_e::moore) {
+    // prefix(u, v) is the sum over [0, u] x [0, v]
+    for (int v = 0; v < side; ++v) {
+      int32_t row = 0;
+      for (int u = 0; u < side; ++u) {
+        row += at(workspace.values, u, v);
+        at(workspace.prefix, u, v) = row + (v > 0 ? at(workspace.prefix, u, v - 1) : 0);
+      }
+    }
+
+    for (int y = 0; y < tile_size; ++y) {
+      int top = y + margin - r - 1;
+      int bottom = y + margin + r;
+      for (int x = 0; x < tile_size; ++x) {
+        int left = x + margin - r - 1;
+        int right = x + margin + r;
+        out[y * tile_size + x] = at(workspace.prefix, right, bottom) - at(workspace.prefix, left, bottom) - at(workspace.prefix, right, top) + at(workspace.prefix, left, top);
+      }
+    }
+    return;
+  }
+
+  // prefix(u, v) is the sum of row v over [0, u], diagonal accumulates it towards (-1, -1) and antidiagonal towards (-1, +1)
+  for (int v = 0; v < side; ++v) {
+    int32_t row = 0;
+    for (int u = 0; u < side; ++u) {
+      row += at(workspace.values, u, v);
+      at(workspace.prefix, u, v) = row;
+      at(workspace.diagonal, u, v) = row + (u > 0 && v > 0 ? at(workspace.diagonal, u - 1, v - 1) : 0);
+    }
+  }
+  for (int v = side - 1; v >= 0; --v) {
+    for (int u = 0; u < side; ++u) at(workspace.antidiagonal, u, v) = at(workspace.prefix, u, v) + (u > 0 && v < side - 1 ? at(workspace.antidiagonal, u - 1, v + 1) : 0);
+  }
+
+  // the diamond is the right ends of its rows less the cells left of its rows, each end a diagonal run of prefixes
+  for (int y = 0; y < tile_size; ++y) {
+    int v = y + margin;
+    for (int x = 0; x < tile_size; ++x) {
+      int u = x + margin;
+      int32_t upper_right = at(workspace.diagonal, u + r, v) - at(workspace.diagonal, u - 1, v - r - 1);
+      int32_t lower_right = at(workspace.antidiagonal, u + r - 1, v + 1) - at(workspace.antidiagonal, u - 1, v + r + 1);
+      int32_t upper_left = at(workspace.antidiagonal, u - 1, v - r) - at(workspace.antidiagonal, u - r - 2, v + 1);
+      int32_t lower_left = at(workspace.diagonal, u - 1, v + r) - at(workspace.diagonal, u - r - 1, v);
+      out[y * tile_size + x] = upper_right + lower_right - upper_left - lower_left;
+    }
+  }
+}
+
+// copies the cells, or one colour channel of them, around a tile into the domain
+auto gather(ltl_t& ltl, workspace_t& workspace, const int tile_x, const int tile_y, const int channel) -> void {
+  const int side = workspace.side;
+  const int margin = workspace.margin;
+  std::ranges::fill(workspace.values, 0);
+
+  for (int delta_y = -1; delta_y <= 1; ++delta_y) {
+    for (int delta_x = -1; delta_x <= 1; ++delta_x) {
+      const tile_t* source = find_tile(ltl, tile_x + delta_x, tile_y + delta_y);
+      if (source == nullptr) continue;
+      const plane_t* plane = channel >= 0 ? &ltl.planes[source - ltl.tiles.data()] : nullptr;
+
+      // the part of the source tile that falls inside the domain
+      int begin_u = std::max(0, delta_x * tile_size + margin);
+      int end_u = std::min(side, delta_x * tile_size + margin + tile_size);
+      int begin_v = std::max(0, delta_y * tile_size + margin);
+      int end_v = std::min(side, delta_y * tile_size + margin + tile_size);
+
+      for (int v = begin_v; v < end_v; ++v) {
+        int row = v - margin - delta_y * tile_size;
+        uint64_t word = source->rows[row];
+        if (word == 0) continue;
+        for (int u = begin_u; u < end_u; ++u) {
+          int column = u - margin - delta_x * tile_size;
+          if (!(word >> column & 1)) continue;
+          workspace.values[static_cast<size_t>(v) * side + u] = plane != nullptr ? (*plane)[channel][row * tile_size + column] : 1;
+        }
+      }
+    }
+  }
+}
+// ----------------------------------------------
+
+auto step_tile(ltl_t& ltl, workspace_t& workspace, const int tile_x, const int tile_y, tile_t& next, plane_t& next_plane) -> void {
+  const rule_t& rule = ltl.rule;
+  const tile_t* tile = find_tile(ltl, tile_x, tile_y);
+  const plane_t* plane = tile != nullptr && ltl.colored ? &ltl.planes[tile - ltl.tiles.data()] : nullptr;
+
+  gather(ltl, workspace, tile_x, tile_y, -1);
+  neighbourhood_sums(workspace, rule, workspace.counts);
+
+  next.x = tile_x;
+  next.y = tile_y;
+  bool births = false;
+  for (int row = 0; row < tile_size; ++row) {
+    uint64_t current = tile != nullptr ? tile->rows[row] : 0;
+    uint64_t word = 0;
+    for (int column = 0; column < tile_size; ++column) {
+      bool alive = current >> column & 1;
+      int count = workspace.counts[row * tile_size + column] - (alive && !rule.middle ? 1 : 0);
+      bool lives = alive ? count >= rule.survival_min && count <= rule.survival_max : count >= rule.birth_min && count <= rule.birth_max;
+      word |= uint64_t{lives} << column;
+    }
+    next.rows[row] = word;
+    births |= (word & ~current) != 0;
+  }
+
+  if (!ltl.colored) return;
+
+  // births take the mean colour of the live cells in their neighbourhood, survivors keep theirs
+  if (births) {
+    for (int channel = 0; channel < 3; ++channel) {
+      gather(ltl, workspace, tile_x, tile_y, channel);
+      neighbourhood_sums(workspace, rule, workspace.sums[channel]);
+    }
+  }
+
+  for (int row = 0; row < tile_size; ++row) {
+    uint64_t current = tile != nullptr ? tile->rows[row] : 0;
+    for (int column = 0; column < tile_size; ++column) {
+      int cell = row * tile_size + column;
+      bool alive = next.rows[row] >> column & 1;
+      bool kept = alive && (current >> column & 1);
+      for (int channel = 0; channel < 3; ++channel) {
+        uint8_t value = 0;
+        if (kept)
+          value = (*plane)[channel][cell];
+        else if (alive)
+          value = static_cast<uint8_t>(workspace.sums[channel][cell] / workspace.counts[cell]);
+        next_plane[channel][cell] = value;
+      }
+    }
+  }
+}
+
+// every stepped tile only reads the current generation, so they run in any order on any thread
+auto step(ltl_t& ltl, pool::pool_t& pool) -> void {
+  sparse::clear(ltl.seen);
+  sparse::reserve(ltl.seen, ltl.tiles.size() * 9);
+  ltl.active.clear();
+  for (const auto& tile : ltl.tiles) {
+    for (int delta_y = -1; delta_y <= 1; ++delta_y) {
+      for (int delta_x = -1; delta_x <= 1; ++delta_x) {
+        if (sparse::insert(ltl.seen, tile::tile_key(tile.x + delta_x, tile.y + delta_y)).second) ltl.active.emplace_back(tile.x + delta_x, tile.y + delta_y);
+      }
+    }
+  }
+
+  ltl.next_tiles.resize(ltl.active.size());
+  if (ltl.colored) ltl.next_planes.resize(ltl.active.size());
+
+  static plane_t unused;
+  pool::parallel_for(pool, ltl.active.size(), [&](const size_t index) {
+    thread_local workspace_t workspace;
+    prepare(workspace, ltl.rule.radius);
+    auto [tile_x, tile_y] = ltl.active[index];
+    step_tile(ltl, workspace, tile_x, tile_y, ltl.next_tiles[index], ltl.colored ? ltl.next_planes[index] : unused);
+  });
+
+  // keep the tiles that still hold cells
+  size_t kept = 0;
+  for (size_t index = 0; index < ltl.next_tiles.size(); ++index) {
+    if (std::ranges::all_of(ltl.next_tiles[index].rows, [](const uint64_t word) { return word == 0; })) continue;
+    if (kept != index) {
+      ltl.next_tiles[kept] = ltl.next_tiles[index];
+      if (ltl.colored) ltl.next_planes[kept] = ltl.next_planes[index];
+    }
+    ++kept;
+  }
+  ltl.next_tiles.resize(kept);
+  if (ltl.colored) ltl.next_planes.resize(kept);
+
+  std::swap(ltl.tiles, ltl.next_tiles);
+  std::swap(ltl.planes, ltl.next_planes);
+
+  sparse::clear(ltl.index);
+  sparse::reserve(ltl.index, ltl.tiles.size());
+  for (size_t index = 0; index < ltl.tiles.size(); ++index) *sparse::insert(ltl.index, tile::tile_key(ltl.tiles[index].x, ltl.tiles[index].y)).first = static_cast<uint32_t>(index);
+}
+
+}  // namespace engine::ltl
@@ -0,0 +1,34 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Engine Parse Functions
+
+#pragma once
+
+#include <charconv>
+#include <string_view>
+#include <system_error>
+
+namespace engine {
+
+// the whole of text as a number, a malformed or out of range value fails rather than throwing
+template <typename value_t>
+auto parse_number(std::string_view text, value_t& value) -> bool {
+  auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+  return error == std::errc() && end == text.data() + text.size();
+}
+
+// a positive width and height written as <width>x<height>
+auto parse_size(std::string_view text, int& width, int& height) -> bool {
+  size_t separator = text.find('x');
+  if (separator == std::string_view::npos) return false;
+  int parsed_width, parsed_height;
+  if (!parse_number(text.substr(0, separator), parsed_width) || !parse_number(text.substr(separator + 1), parsed_height)) return false;
+  if (parsed_width < 1 || parsed_height < 1) return false;
+  width = parsed_width;
+  height = parsed_height;
+  return true;
+}
+
+}  // namespace engine
@@ -0,0 +1,152 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Engine Pool Functions
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "profile.hpp"
+
+namespace engine::pool {
+
+// each participant owns a contiguous range of the work and claims it a grain
+// at a time, once its own range is exhausted it steals grains from the others
+struct alignas(64) range_t {
+  std::atomic<size_t> next{0};
+  size_t end{0};
+};
+
+struct pool_t {
+  std::vector<std::thread> workers;
+  std::unique_ptr<range_t[]> ranges;
+  size_t participants{1};
+
+  std::mutex mutex;
+  std::condition_variable start;
+  std::condition_variable done;
+
+  uint64_t epoch{0};
+  size_t running{0};
+  bool stopping{false};
+
+  // the current task, type erased so that starting a job does not allocate
+  void (*invoke)(void*, size_t, size_t){nullptr};
+  void* context{nullptr};
+  size_t grain{1};
+
+  std::atomic<uint64_t> steals{0};
+
+  pool_t() = default;
+  pool_t(const pool_t&) = delete;
+  auto operator=(const pool_t&) -> pool_t& = delete;
+
+  ~pool_t() { stop(); }
+
+  auto stop() -> void {
+    {
+      std::lock_guard lock(mutex);
+      stopping = true;
+    }
+    start.notify_all();
+    for (auto& worker : workers) worker.join();
+    workers.clear();
+    stopping = false;
+  }
+};
+
+auto run_range(pool_t& pool, range_t& range) -> size_t {
+  size_t claimed = 0;
+  for (size_t begin = range.next.fetch_add(pool.grain); begin < range.end; begin = range.next.fetch_add(pool.grain)) {
+    pool.invoke(pool.context, begin, std::min(begin + pool.grain, range.end));
+    ++claimed;
+  }
+  return claimed;
+}
+
+auto participate(pool_t& pool, const size_t participant) -> void {
+  profile::scope_t scope(profile::timer_e::pool_work);
+  run_range(pool, pool.ranges[participant]);
+  for (size_t offset = 1; offset < pool.participants; ++offset) {
+    size_t victim = (participant + offset) % pool.participants;
+    pool.steals += run_range(pool, pool.ranges[victim]);
+  }
+}
+
+auto work(pool_t& pool, const size_t participant, uint64_t seen) -> void {
+  profile::trace::name_thread("worker");
+  while (true) {
+    {
+      std::unique_lock lock(pool.mutex);
+      pool.start.wait(lock, [&] { return pool.stopping || pool.epoch != seen; });
+      if (pool.stopping) return;
+      seen = pool.epoch;
+    }
+
+    participate(pool, participant);
+
+    {
+      std::lock_guard lock(pool.mutex);
+      --pool.running;
+    }
+    pool.done.notify_one();
+  }
+}
+
+// the calling thread takes part, so a pool of n threads starts n - 1 workers
+auto resize(pool_t& pool, size_t threads) -> void {
+  threads = std::max<size_t>(threads, 1);
+  if (threads == pool.participants && pool.workers.size() + 1 == threads) return;
+
+  pool.stop();
+  pool.participants = threads;
+  pool.ranges = std::make_unique<range_t[]>(threads);
+  for (size_t participant = 1; participant < threads; ++participant) pool.workers.emplace_back(work, std::ref(pool), participant, pool.epoch);
+}
+
+auto threads(const pool_t& pool) -> size_t { return pool.participants; }
+
+// calls function(index) for every index in [0, count), returning once all have finished
+template <typename function_t>
+auto parallel_for(pool_t& pool, const size_t count, function_t&& function, const size_t grain = 1) -> void {
+  if (pool.participants <= 1 || count <= grain) {
+    for (size_t index = 0; index < count; ++index) function(index);
+    return;
+  }
+
+  pool.invoke = [](void* context, size_t begin, size_t end) {
+    auto& function = *static_cast<std::remove_reference_t<function_t>*>(context);
+    for (size_t index = begin; index < end; ++index) function(index);
+  };
+  pool.context = const_cast<void*>(static_cast<const void*>(std::addressof(function)));
+  pool.grain = grain;
+
+  size_t share = (count + pool.participants - 1) / pool.participants;
+  for (size_t participant = 0; participant < pool.participants; ++participant) {
+    pool.ranges[participant].next = std::min(participant * share, count);
+    pool.ranges[participant].end = std::min((participant + 1) * share, count);
+  }
+
+  {
+    std::lock_guard lock(pool.mutex);
+    pool.running = pool.workers.size();
+    ++pool.epoch;
+  }
+  pool.start.notify_all();
+
+  participate(pool, 0);
+
+  std::unique_lock lock(pool.mutex);
+  pool.done.wait(lock, [&] { return pool.running == 0; });
+}
+
+}  // namespace engine::pool
@@ -0,0 +1,112 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Engine Pyramid Functions
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <vector>
+
+#include "engine_cell.hpp"
+#include "engine_index.hpp"
+#include "engine_sparse.hpp"
+
+namespace engine::pyramid {
+
+// level k aggregates 2^k x 2^k cells per block, levels are built lazily from the one below and
+// only over the blocks in view, so a frame costs what the window shows rather than the population
+constexpr int max_level = 24;
+
+struct block_t {
+  int x;
+  int y;
+  uint64_t count;
+  std::array<uint64_t, 3> color_sum;
+};
+
+struct level_t {
+  sparse::table_t<uint32_t> lookup;
+  std::vector<block_t> blocks;
+};
+
+struct pyramid_t {
+  std::array<level_t, max_level + 1> levels;
+
+  // the engine revision and rectangle the levels were built from, and the range of levels that are current
+  uint64_t revision{~uint64_t{0}};
+  std::array<int, 4> rect{0, 0, -1, -1};
+  int base{0};
+  int built{0};
+};
+
+auto accumulate(level_t& level, const int x, const int y, const uint64_t count, const std::array<uint64_t, 3>& color_sum) -> void {
+  auto [slot, inserted] = sparse::insert(level.lookup, pack_coord(x, y));
+  if (inserted) {
+    *slot = static_cast<uint32_t>(level.blocks.size());
+    level.blocks.push_back(block_t{x, y, 0, {0, 0, 0}});
+  }
+
+  block_t& block = level.blocks[*slot];
+  block.count += count;
+  for (int channel = 0; channel < 3; ++channel) block.color_sum[channel] += color_sum[channel];
+}
+
+auto reset(level_t& level, const size_t expected) -> void {
+  sparse::clear(level.lookup);
+  sparse::reserve(level.lookup, expected);
+  level.blocks.clear();
+}
+
+// cells below the chunk size are taken one at a time, the index's chunks are whole blocks above it
+auto build_base(level_t& level, const int k, const index::index_t& index, const std::vector<cell_t>& cells, const std::array<int, 4>& rect) -> void {
+  reset(level, 0);
+  auto [min_x, min_y, max_x, max_y] = rect;
+  if (k >= index::chunk_shift) {
+    int shift = k - index::chunk_shift;
+    index::query_chunks(index, min_x, min_y, max_x, max_y, [&](const index::chunk_t& chunk) { accumulate(level, chunk.x >> shift, chunk.y >> shift, chunk.end - chunk.begin, chunk.color_sum); });
+    return;
+  }
+  index::query(index, cells, min_x, min_y, max_x, max_y, [&](const cell_t& cell) { accumulate(level, cell.coord.first >> k, cell.coord.second >> k, 1, {cell.color[0], cell.color[1], cell.color[2]}); });
+}
+
+auto build_level(const level_t& source, level_t& level) -> void {
+  reset(level, source.blocks.size() >> 2);
+  for (const auto& block : source.blocks) accumulate(level, block.x >> 1, block.y >> 1, block.count, block.color_sum);
+}
+
+// widens the inclusive rectangle out to whole 2^shift x 2^shift blocks
+auto block_rect(const int shift, const int min_x, const int min_y, const int max_x, const int max_y) -> std::array<int, 4> {
+  auto floor_to = [shift](const int coord) { return static_cast<int>((int64_t{coord} >> shift) << shift); };
+  auto ceil_to = [shift](const int coord) { return static_cast<int>(std::min<int64_t>(((int64_t{coord} >> shift) << shift) + (int64_t{1} << shift) - 1, INT_MAX)); };
+  return {floor_to(min_x), floor_to(min_y), ceil_to(max_x), ceil_to(max_y)};
+}
+
+// returns level k >= 1 over the inclusive rectangle of cells, rebuilding only the levels up to k that are out of date
+auto level(pyramid_t& pyramid, const index::index_t& index, const std::vector<cell_t>& cells, const uint64_t revision, const int k, const int min_x, const int min_y, const int max_x, const int max_y) -> level_t& {
+  int base = std::min(k, index::chunk_shift);
+  auto rect = block_rect(std::max(k, index::chunk_shift), min_x, min_y, max_x, max_y);
+  if (pyramid.revision != revision || pyramid.rect != rect || pyramid.base != base || pyramid.built > k) {
+    pyramid.revision = revision;
+    pyramid.rect = rect;
+    pyramid.base = base;
+    pyramid.built = 0;
+  }
+
+  if (pyramid.built < base) {
+    build_base(pyramid.levels[base], base, index, cells, rect);
+    pyramid.built = base;
+  }
+  for (; pyramid.built < k; ++pyramid.built) build_level(pyramid.levels[pyramid.built], pyramid.levels[pyramid.built + 1]);
+  return pyramid.levels[k];
+}
+
+auto find(level_t& level, const int x, const int y) -> const block_t* {
+  const uint32_t* slot = sparse::find(level.lookup, pack_coord(x, y));
+  return slot != nullptr ? &level.blocks[*slot] : nullptr;
+}
+
+}  // namespace engine::pyramid
@@ -0,0 +1,124 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Engine Rule Functions
+
+#pragma once
+
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace engine::rule {
+
+// bit n of birth is set when a dead cell with n live neighbours is born,
+// bit n of survival when a live cell with n live neighbours survives
+struct rule_t {
+  uint16_t birth;
+  uint16_t survival;
+
+  auto operator<=>(const rule_t&) const = default;
+};
+
+constexpr rule_t conway{1 << 3, 1 << 2 | 1 << 3};
+
+// rules are template arguments packed into one word, generic means the masks are read at runtime
+using packed_t = uint32_t;
+constexpr packed_t generic = ~packed_t{0};
+
+constexpr auto pack(const rule_t rule) -> packed_t { return packed_t{rule.birth} | packed_t{rule.survival} << 9; }
+constexpr auto unpack(const packed_t packed) -> rule_t { return rule_t{static_cast<uint16_t>(packed & 0x1FF), static_cast<uint16_t>(packed >> 9 & 0x1FF)}; }
+
+// the rule a kernel runs, fixed at compile time unless it was instantiated as generic
+template <packed_t packed>
+constexpr auto resolve(const rule_t rule) -> rule_t {
+  if constexpr (packed == generic)
+    return rule;
+  else
+    return unpack(packed);
+}
+
+constexpr auto born(const rule_t rule, const int count) -> bool { return rule.birth >> count & 1; }
+constexpr auto survives(const rule_t rule, const int count) -> bool { return rule.survival >> count & 1; }
+
+// parses B3/S23 style rulestrings, either half may be empty but B0 is rejected
+// since it would fill the infinite dead plane in a single generation
+auto parse(std::string_view text, rule_t& rule) -> bool {
+  rule_t parsed{0, 0};
+  uint16_t* mask = nullptr;
+  bool seen_birth = false;
+  bool seen_survival = false;
+
+  for (const char letter : text) {
+    char lower = static_cast<char>(std::tolower(static_cast<unsigned char>(letter)));
+    if (lower == 'b' && !seen_birth) {
+      mask = &parsed.birth;
+      seen_birth = true;
+    } else if (lower == 's' && !seen_survival) {
+      mask = &parsed.survival;
+      seen_survival = true;
+    } else if (letter >= '0' && letter <= '8' && mask != nullptr) {
+      *mask |= 1 << (letter - '0');
+    } else if (letter != '/') {
+      return false;
+    }
+  }
+
+  if (!seen_birth || !seen_survival || born(parsed, 0)) return false;
+  rule = parsed;
+  return true;
+}
+
+auto format(const rule_t rule) -> std::string {
+  std::string text = "B";
+  for (int count = 0; count <= 8; ++count)
+    if (born(rule, count)) text += static_cast<char>('0' + count);
+  text += "/S";
+  for (int count = 0; count <= 8; ++count)
+    if (survives(rule, count)) text += static_cast<char>('0' + count);
+  return text;
+}
+
+constexpr auto mask(std::initializer_list<int> counts) -> uint16_t {
+  uint16_t bits = 0;
+  for (const int count : counts) bits |= 1 << count;
+  return bits;
+}
+
+// rules with their own specialised kernels, every other rule runs the generic ones
+constexpr std::array<rule_t, 8> common{
+    conway,                                                  // life
+    rule_t{mask({3, 6}), mask({2, 3})},                      // highlife
+    rule_t{mask({3, 6, 7, 8}), mask({3, 4, 6, 7, 8})},       // day & night
+    rule_t{mask({2}), 0},                                    // seeds
+    rule_t{mask({3}), mask({0, 1, 2, 3, 4, 5, 6, 7, 8})},    // life without death
+    rule_t{mask({3}), mask({1, 2, 3, 4, 5})},                // maze
+    rule_t{mask({3, 6}), mask({1, 2, 5})},                   // 2x2
+    rule_t{mask({1, 3, 5, 7}), mask({1, 3, 5, 7})},          // replicator
+};
+
+template <typename function_t, size_t... indices>
+auto dispatch(const rule_t rule, function_t&& function, std::index_sequence<indices...>) -> void {
+  bool specialised = ((rule == common[indices] && (function.template operator()<pack(common[indices])>(), true)) || ...);
+  if (!specialised) function.template operator()<generic>();
+}
+
+// calls function.template operator()<packed>() with the rule's specialisation
+template <typename function_t>
+auto dispatch(const rule_t rule, function_t&& function) -> void {
+  dispatch(rule, std::forward<function_t>(function), std::make_index_sequence<common.size()>());
+}
+
+// the next common rule, for cycling through them
+auto next_common(const rule_t rule) -> rule_t {
+  for (size_t index = 0; index < common.size(); ++index)
+    if (common[index] == rule) return common[(index + 1) % common.size()];
+  return common[0];
+}
+
+}  // namespace engine::rule
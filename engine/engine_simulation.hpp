@@ -0,0 +1,486 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Engine Simulation Functions
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "engine.hpp"
+#include "engine_history.hpp"
+#include "engine_index.hpp"
+#include "profile.hpp"
+
+namespace engine::simulation {
+
+// edits are applied by the simulation thread between generations, in the order they were queued
+enum struct edit_e : uint8_t { add, remove, toggle, append, clear, select, step_exponent, step, rule, rulestring, restore, rewind };
+
+// select and step_exponent carry their value in x, rule carries its birth mask in x and survival mask in y
+// rulestring takes the next rule handed to queue_rulestring, restore the next board handed to restore,
+// rewind carries the generations to go back in x
+struct edit_t {
+  edit_e kind;
+  int x;
+  int y;
+  color_t color;
+};
+
+// engine state copied out with every snapshot, the engine itself belongs to the simulation thread
+struct stats_t {
+  kind_e kind{kind_e::sparse};
+  rule::rule_t rule{rule::conway};
+  ltl::rule_t ltl_rule{ltl::bosco};
+  world::topology_e topology{world::topology_e::plane};
+  int world_width{0};
+  int world_height{0};
+  uint64_t generation{0};
+  int step_exponent{0};
+  uint64_t step_size{1};
+  size_t threads{1};
+  uint64_t steals{0};
+
+  uint64_t step_ns{0};
+  double generations_per_second{0.0};
+
+  size_t tiles{0};
+  size_t tiles_computed{0};
+  size_t tiles_skipped{0};
+  size_t tiles_woken{0};
+  uint64_t tiles_total_computed{0};
+  uint64_t tiles_total_skipped{0};
+  uint64_t tiles_total_woken{0};
+
+  size_t hashlife_nodes{0};
+  double hashlife_hit_rate{0.0};
+  size_t hashlife_memory{0};
+  size_t hashlife_memory_limit{0};
+  uint64_t hashlife_collections{0};
+
+  size_t history_memory{0};
+  size_t history_capacity{0};
+  size_t history_records{0};
+  uint64_t history_oldest{0};
+};
+
+// a whole board handed over at once, swapped in by a restore edit
+struct restore_t {
+  std::vector<cell_t> cells;
+  uint64_t generation{0};
+  std::string rule;
+};
+
+// the index is built by the writer so the reader never has to go through every cell
+struct snapshot_t {
+  std::vector<cell_t> cells;
+  index::index_t index;
+  uint64_t revision{0};
+  stats_t stats;
+};
+
+// Triple Buffer --------------------------------
+// the writer owns back, the reader owns front, middle is swapped atomically with the fresh bit
+// marking a snapshot the reader has not picked up yet
+constexpr uint8_t index_mask = 0x3;
+constexpr uint8_t fresh = 0x4;
+// ----------------------------------------------
+
+struct simulation_t {
+  engine_t engine;
+  std::vector<cell_t> cells;
+
+  // the recent past of cells, for rewinding
+  history::history_t history;
+
+  // called on the simulation thread with every snapshot's cells, their generation, colouring and
+  // revision, and the last step's changes when they lead up to that revision, set before the thread starts
+  void (*observe)(const std::vector<cell_t>&, uint64_t, bool, uint64_t, const history::delta_t*, void*){nullptr};
+  void* observer{nullptr};
+
+  // the changes the history diffed on the last step, no births when it diffed nothing
+  history::delta_t delta{0, 0, nullptr, nullptr};
+
+  // called on the simulation thread once a snapshot is ready to be picked up, to wake the reader
+  void (*published)(void*){nullptr};
+  void* listener{nullptr};
+
+  std::array<snapshot_t, 3> snapshots;
+  std::atomic<uint8_t> middle{1};
+  uint8_t back{0};
+  uint8_t front{2};
+
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::vector<edit_t> edits;
+  std::vector<edit_t> applying;
+  std::deque<std::string> rulestrings;
+  std::deque<restore_t> restoring;
+
+  // where each cell sits in cells, built by the first cell edit that has to look one up and kept
+  // up to date by the edits after it until a step or another edit rebuilds cells
+  sparse::table_t<uint32_t> positions;
+  bool indexed{false};
+
+  std::atomic<bool> updating{false};
+  std::atomic<bool> stopping{false};
+
+  // generations per second while updating, zero runs flat out
+  std::atomic<double> rate{0.0};
+
+  uint64_t step_ns{0};
+  double generations_per_second{0.0};
+  uint64_t window_generation{0};
+  std::chrono::steady_clock::time_point window_begin;
+
+  std::thread thread;
+
+  simulation_t() = default;
+  simulation_t(const simulation_t&) = delete;
+  auto operator=(const simulation_t&) -> simulation_t& = delete;
+
+  ~simulation_t() {
+    {
+      std::scoped_lock lock(mutex);
+      stopping = true;
+    }
+    wake.notify_one();
+    if (thread.joinable()) thread.join();
+  }
+};
+
+auto fill_stats(const simulation_t& simulation, stats_t& stats) -> void {
+  const engine_t& engine = simulation.engine;
+  stats.kind = engine.kind;
+  stats.rule = engine.rule;
+  stats.ltl_rule = engine.ltl.rule;
+  stats.topology = engine.world.topology;
+  stats.world_width = engine.world.width;
+  stats.world_height = engine.world.height;
+  stats.generation = engine.generation;
+  stats.step_exponent = engine.step_exponent;
+  stats.step_size = step_size(engine);
+  stats.threads = pool::threads(engine.pool);
+  stats.steals = engine.pool.steals.load(std::memory_order_relaxed);
+  stats.step_ns = simulation.step_ns;
+  stats.generations_per_second = simulation.generations_per_second;
+
+  stats.tiles = engine.tiles.tiles.size();
+  stats.tiles_computed = engine.tiles.computed;
+  stats.tiles_skipped = engine.tiles.skipped;
+  stats.tiles_woken = engine.tiles.woken;
+  stats.tiles_total_computed = engine.tiles.total_computed;
+  stats.tiles_total_skipped = engine.tiles.total_skipped;
+  stats.tiles_total_woken = engine.tiles.total_woken;
+
+  stats.hashlife_nodes = engine.hashlife.nodes.size();
+  stats.hashlife_hit_rate = hashlife::hit_rate(engine.hashlife);
+  stats.hashlife_memory = hashlife::memory_usage(engine.hashlife);
+  stats.hashlife_memory_limit = engine.hashlife.memory_limit;
+  stats.hashlife_collections = engine.hashlife.collections;
+
+  stats.history_memory = history::memory_usage(simulation.history);
+  stats.history_capacity = simulation.history.capacity;
+  stats.history_records = simulation.history.count;
+  stats.history_oldest = history::oldest_generation(simulation.history);
+}
+
+// writer side, copies the cells into the back buffer and swaps it into the middle
+auto publish(simulation_t& simulation) -> void {
+  snapshot_t& snapshot = simulation.snapshots[simulation.back];
+  snapshot.cells.assign(std::begin(simulation.cells), std::end(simulation.cells));
+  snapshot.revision = simulation.engine.revision;
+  if (snapshot.index.revision != snapshot.revision) index::build(snapshot.index, snapshot.cells, snapshot.revision);
+  fill_stats(simulation, snapshot.stats);
+  if (simulation.observe != nullptr) {
+    const engine_t& engine = simulation.engine;
+    const history::delta_t* delta = simulation.delta.births != nullptr && simulation.delta.to == engine.revision ? &simulation.delta : nullptr;
+    simulation.observe(simulation.cells, engine.generation, !engine.colorless, engine.revision, delta, simulation.observer);
+  }
+
+  simulation.back = simulation.middle.exchange(simulation.back | fresh, std::memory_order_acq_rel) & index_mask;
+  if (simulation.published != nullptr) simulation.published(simulation.listener);
+}
+
+// reader side, true when a snapshot has been published since the last call to latest
+auto fresh_snapshot(const simulation_t& simulation) -> bool { return simulation.middle.load(std::memory_order_acquire) & fresh; }
+
+// reader side, the most recently published snapshot, never blocks
+auto latest(simulation_t& simulation) -> const snapshot_t& {
+  if (simulation.middle.load(std::memory_order_relaxed) & fresh) simulation.front = simulation.middle.exchange(simulation.front, std::memory_order_acq_rel) & index_mask;
+  return simulation.snapshots[simulation.front];
+}
+
+auto queue(simulation_t& simulation, const edit_t& edit) -> void {
+  {
+    std::scoped_lock lock(simulation.mutex);
+    simulation.edits.push_back(edit);
+  }
+  simulation.wake.notify_one();
+}
+
+auto queue(simulation_t& simulation, const std::vector<edit_t>& edits) -> void {
+  {
+    std::scoped_lock lock(simulation.mutex);
+    simulation.edits.insert(std::end(simulation.edits), std::begin(edits), std::end(edits));
+  }
+  simulation.wake.notify_one();
+}
+
+// sets a B/S or larger than life rule between generations, in order with the edits queued before it
+auto queue_rulestring(simulation_t& simulation, std::string rulestring) -> void {
+  {
+    std::scoped_lock lock(simulation.mutex);
+    simulation.rulestrings.push_back(std::move(rulestring));
+    simulation.edits.push_back({edit_e::rulestring, 0, 0, {}});
+  }
+  simulation.wake.notify_one();
+}
+
+auto apply_rulestring(simulation_t& simulation) -> void {
+  std::string rulestring;
+  {
+    std::scoped_lock lock(simulation.mutex);
+    if (simulation.rulestrings.empty()) return;
+    rulestring = std::move(simulation.rulestrings.front());
+    simulation.rulestrings.pop_front();
+  }
+  engine::set_rulestring(simulation.engine, rulestring);
+}
+
+// replaces the board, generation and rule between generations, the cells are moved rather than copied
+auto restore(simulation_t& simulation, restore_t board) -> void {
+  {
+    std::scoped_lock lock(simulation.mutex);
+    simulation.restoring.push_back(std::move(board));
+    simulation.edits.push_back({edit_e::restore, 0, 0, {}});
+  }
+  simulation.wake.notify_one();
+}
+
+// false when there is no board waiting, which leaves the cells as they were
+auto restore_board(simulation_t& simulation) -> bool {
+  restore_t board;
+  {
+    std::scoped_lock lock(simulation.mutex);
+    if (simulation.restoring.empty()) return false;
+    board = std::move(simulation.restoring.front());
+    simulation.restoring.pop_front();
+  }
+
+  simulation.cells.swap(board.cells);
+  simulation.engine.generation = board.generation;
+  engine::set_rulestring(simulation.engine, board.rule);
+  return true;
+}
+
+auto set_updating(simulation_t& simulation, const bool updating) -> void {
+  {
+    std::scoped_lock lock(simulation.mutex);
+    simulation.updating = updating;
+  }
+  simulation.wake.notify_one();
+}
+
+auto set_rate(simulation_t& simulation, const double rate) -> void {
+  {
+    std::scoped_lock lock(simulation.mutex);
+    simulation.rate = std::max(rate, 0.0);
+  }
+  simulation.wake.notify_one();
+}
+
+auto step(simulation_t& simulation) -> void {
+  profile::scope_t scope(profile::timer_e::update_cells);
+
+  engine_t& engine = simulation.engine;
+  history::prepare(simulation.history, simulation.cells, engine.generation, !engine.colorless);
+  uint64_t from = engine.revision;
+
+  using clock = std::chrono::steady_clock;
+  auto begin = clock::now();
+  engine::step(engine, simulation.cells);
+  auto end = clock::now();
+  simulation.step_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+  simulation.indexed = false;
+
+  bool diffed = history::record(simulation.history, simulation.cells, engine.generation, !engine.colorless);
+  simulation.delta = diffed ? history::delta_t{from, engine.revision, &simulation.history.births, &simulation.history.deaths} : history::delta_t{0, 0, nullptr, nullptr};
+
+  // the measured rate is refreshed twice a second
+  auto elapsed = std::chrono::duration<double>(end - simulation.window_begin).count();
+  if (elapsed >= 0.5) {
+    simulation.generations_per_second = static_cast<double>(engine.generation - simulation.window_generation) / elapsed;
+    simulation.window_generation = engine.generation;
+    simulation.window_begin = end;
+  }
+}
+
+auto cell_edit(const edit_e kind) -> bool { return kind == edit_e::add || kind == edit_e::remove || kind == edit_e::toggle || kind == edit_e::append; }
+
+// applies a run of cell edits in one pass, a removed cell is swapped with the last, true when any cell changed
+auto apply_cells(simulation_t& simulation, const edit_t* first, const edit_t* last) -> bool {
+  auto& cells = simulation.cells;
+  auto& positions = simulation.positions;
+  bool& indexed = simulation.indexed;
+  bool edited = false;
+
+  auto index = [&] {
+    sparse::clear(positions);
+    sparse::reserve(positions, cells.size());
+    for (size_t position = 0; position < cells.size(); ++position) *sparse::insert(positions, pack_coord(cells[position].coord)).first = static_cast<uint32_t>(position);
+    indexed = true;
+  };
+
+  auto add = [&](const uint64_t key, const edit_t& edit) {
+    if (indexed) *sparse::insert(positions, key).first = static_cast<uint32_t>(cells.size());
+    cells.push_back(cell_t{{edit.x, edit.y}, edit.color});
+    edited = true;
+  };
+
+  auto remove = [&](const uint64_t key, const uint32_t position) {
+    if (position + 1 != cells.size()) {
+      cells[position] = cells.back();
+      *sparse::find(positions, pack_coord(cells[position].coord)) = position;
+    }
+    cells.pop_back();
+    sparse::erase(positions, key);
+    edited = true;
+  };
+
+  for (const edit_t* next = first; next != last; ++next) {
+    // cell edits land on the world, a bounded one ignores those beyond its edges
+    edit_t edit = *next;
+    if (!world::confine(simulation.engine.world, edit.x, edit.y)) continue;
+
+    uint64_t key = pack_coord(edit.x, edit.y);
+    if (edit.kind == edit_e::append) {
+      add(key, edit);
+      continue;
+    }
+
+    if (!indexed) index();
+    const uint32_t* found = sparse::find(positions, key);
+    switch (edit.kind) {
+      case edit_e::add:
+        if (found == nullptr) add(key, edit);
+        break;
+      case edit_e::remove:
+        if (found != nullptr) remove(key, *found);
+        break;
+      case edit_e::toggle:
+        if (found != nullptr)
+          remove(key, *found);
+        else
+          add(key, edit);
+        break;
+      default: break;
+    }
+  }
+  return edited;
+}
+
+// returns true when a new snapshot is due
+auto apply(simulation_t& simulation) -> bool {
+  auto& cells = simulation.cells;
+  auto& applying = simulation.applying;
+  bool changed = false;
+
+  for (size_t next = 0; next < applying.size();) {
+    bool edited = false;
+    edit_t edit = applying[next];
+
+    // consecutive cell edits are applied together
+    if (cell_edit(edit.kind)) {
+      size_t end = next;
+      while (end < applying.size() && cell_edit(applying[end].kind)) ++end;
+      edited = apply_cells(simulation, applying.data() + next, applying.data() + end);
+      next = end;
+    } else {
+      ++next;
+    }
+
+    switch (edit.kind) {
+      // applied above along with the rest of their run
+      case edit_e::add:
+      case edit_e::remove:
+      case edit_e::toggle:
+      case edit_e::append: break;
+      case edit_e::clear:
+        cells.clear();
+        edited = true;
+        break;
+      case edit_e::select: engine::select(simulation.engine, static_cast<kind_e>(edit.x)); break;
+      case edit_e::step_exponent: engine::set_step_exponent(simulation.engine, edit.x); break;
+      case edit_e::step: step(simulation); break;
+      case edit_e::rule: engine::set_rule(simulation.engine, rule::rule_t{static_cast<uint16_t>(edit.x), static_cast<uint16_t>(edit.y)}); break;
+      case edit_e::rulestring: apply_rulestring(simulation); break;
+      case edit_e::restore: edited = restore_board(simulation); break;
+      case edit_e::rewind:
+        edited = history::rewind(simulation.history, static_cast<uint64_t>(edit.x), cells, simulation.engine.generation);
+        simulation.window_generation = std::min(simulation.window_generation, simulation.engine.generation);
+        break;
+    }
+
+    // a rewound board is the one the history holds, any other edit leaves it behind, and only
+    // cell edits keep the positions of the cells up to date
+    if (edited) touch(simulation.engine);
+    if (edited && !cell_edit(edit.kind)) simulation.indexed = false;
+    if (edited && edit.kind != edit_e::rewind) simulation.history.synced = false;
+    changed = true;
+  }
+
+  applying.clear();
+  return changed;
+}
+
+// the simulation thread, sleeps while paused with nothing queued and paces itself to the target rate
+auto run(simulation_t& simulation) -> void {
+  profile::trace::name_thread("simulation");
+
+  using clock = std::chrono::steady_clock;
+  auto next = clock::now();
+  simulation.window_begin = next;
+  publish(simulation);
+
+  while (!simulation.stopping) {
+    {
+      std::unique_lock lock(simulation.mutex);
+      simulation.wake.wait(lock, [&simulation] { return simulation.stopping || simulation.updating || !simulation.edits.empty(); });
+      simulation.applying.swap(simulation.edits);
+    }
+    bool changed = apply(simulation);
+
+    if (simulation.updating) {
+      double rate = simulation.rate;
+      auto now = clock::now();
+      if (rate > 0.0 && now < next) {
+        // wait for the next tick, waking early for edits so they are never held back a whole period
+        std::unique_lock lock(simulation.mutex);
+        simulation.wake.wait_until(lock, next, [&simulation] { return simulation.stopping || !simulation.updating || !simulation.edits.empty(); });
+      } else {
+        step(simulation);
+        changed = true;
+        next = rate > 0.0 ? std::max(next + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / rate)), now) : now;
+      }
+    }
+
+    if (changed) publish(simulation);
+  }
+}
+
+// the engine must be configured before the thread starts, afterwards only edits reach it
+auto start(simulation_t& simulation) -> void { simulation.thread = std::thread(run, std::ref(simulation)); }
+
+}  // namespace engine::simulation
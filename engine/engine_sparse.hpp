@@ -0,0 +1,200 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Engine Sparse Functions
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "engine_cell.hpp"
+#include "engine_rule.hpp"
+#include "profile.hpp"
+
+namespace engine::sparse {
+
+// open addressing hash table keyed by packed coordinates
+// storage is kept between generations, clear only resets the occupancy
+template <typename value_t>
+struct table_t {
+  std::vector<uint64_t> keys;
+  std::vector<value_t> values;
+  std::vector<uint8_t> used;
+
+  size_t size{0};
+  size_t mask{0};
+};
+
+auto hash_key(const uint64_t key) -> uint64_t {
+  uint64_t hash = key * 0x9E3779B97F4A7C15ull;
+  return hash ^ (hash >> 29);
+}
+
+template <typename value_t>
+auto clear(table_t<value_t>& table) -> void {
+  std::fill(std::begin(table.used), std::end(table.used), 0);
+  table.size = 0;
+}
+
+template <typename value_t>
+auto rehash(table_t<value_t>& table, size_t capacity) -> void {
+  profile::count(profile::counter_e::allocations);
+
+  table_t<value_t> rehashed;
+  rehashed.keys.resize(capacity);
+  rehashed.values.resize(capacity);
+  rehashed.used.resize(capacity, 0);
+  rehashed.mask = capacity - 1;
+
+  for (size_t slot = 0; slot < table.used.size(); ++slot) {
+    if (!table.used[slot]) continue;
+    size_t index = hash_key(table.keys[slot]) & rehashed.mask;
+    while (rehashed.used[index]) index = (index + 1) & rehashed.mask;
+    rehashed.keys[index] = table.keys[slot];
+    rehashed.values[index] = table.values[slot];
+    rehashed.used[index] = 1;
+  }
+  rehashed.size = table.size;
+
+  table = std::move(rehashed);
+}
+
+// keep the load factor at or below one half
+template <typename value_t>
+auto reserve(table_t<value_t>& table, size_t count) -> void {
+  size_t capacity = 16;
+  while (capacity < count * 2) capacity <<= 1;
+  if (capacity > table.used.size()) rehash(table, capacity);
+}
+
+template <typename value_t>
+auto find(table_t<value_t>& table, const uint64_t key) -> value_t* {
+  if (table.size == 0) return nullptr;
+  size_t index = hash_key(key) & table.mask;
+  while (table.used[index]) {
+    if (table.keys[index] == key) return &table.values[index];
+    index = (index + 1) & table.mask;
+  }
+  return nullptr;
+}
+
+template <typename value_t>
+auto find(const table_t<value_t>& table, const uint64_t key) -> const value_t* {
+  return find(const_cast<table_t<value_t>&>(table), key);
+}
+
+// returns the value for key and whether it was newly inserted
+template <typename value_t>
+auto insert(table_t<value_t>& table, const uint64_t key) -> std::pair<value_t*, bool> {
+  if ((table.size + 1) * 2 > table.used.size()) reserve(table, table.size + 1);
+  size_t index = hash_key(key) & table.mask;
+  while (table.used[index]) {
+    if (table.keys[index] == key) return std::make_pair(&table.values[index], false);
+    index = (index + 1) & table.mask;
+  }
+  table.keys[index] = key;
+  table.values[index] = value_t{};
+  table.used[index] = 1;
+  ++table.size;
+  return std::make_pair(&table.values[index], true);
+}
+
+// backward shift deletion, entries after the hole that probed past it move back into it
+template <typename value_t>
+auto erase(table_t<value_t>& table, const uint64_t key) -> bool {
+  if (table.size == 0) return false;
+  size_t hole = hash_key(key) & table.mask;
+  while (table.used[hole] && table.keys[hole] != key) hole = (hole + 1) & table.mask;
+  if (!table.used[hole]) return false;
+
+  for (size_t index = (hole + 1) & table.mask; table.used[index]; index = (index + 1) & table.mask) {
+    size_t home = hash_key(table.keys[index]) & table.mask;
+    bool stays = hole <= index ? hole < home && home <= index : hole < home || home <= index;
+    if (stays) continue;
+    table.keys[hole] = table.keys[index];
+    table.values[hole] = table.values[index];
+    hole = index;
+  }
+  table.used[hole] = 0;
+  --table.size;
+  return true;
+}
+
+struct candidate_t {
+  int count;
+  color_sum_t color_sum;
+};
+
+struct sparse_t {
+  table_t<uint8_t> live;
+  table_t<candidate_t> candidates;
+
+  std::vector<cell_t> previous_cells;
+  std::vector<std::pair<uint64_t, color_t>> births;
+
+  // colourless steps skip the parent sums and give every birth white
+  bool colored{true};
+
+  rule::rule_t rule{rule::conway};
+};
+
+// advances cells by one generation of the rule
+// survivors keep their order, births follow in coordinate order, and birth
+// colours are the mean of the parents, whatever order they are visited in
+template <rule::packed_t packed>
+auto step(sparse_t& sparse, std::vector<cell_t>& cells) -> void {
+  const rule::rule_t active = rule::resolve<packed>(sparse.rule);
+
+  std::swap(sparse.previous_cells, cells);
+  cells.clear();
+
+  const auto& previous_cells = sparse.previous_cells;
+
+  clear(sparse.live);
+  reserve(sparse.live, previous_cells.size());
+  for (const auto& cell : previous_cells) insert(sparse.live, pack_coord(cell.coord));
+
+  clear(sparse.candidates);
+  reserve(sparse.candidates, previous_cells.size() * 2);
+
+  for (const auto& cell : previous_cells) {
+    int neighbour_count = 0;
+
+    int x = cell.coord.first;
+    int y = cell.coord.second;
+    for (const auto& [delta_x, delta_y] : neighbour_deltas) {
+      uint64_t key = pack_coord(x + delta_x, y + delta_y);
+      if (find(sparse.live, key) != nullptr) {
+        ++neighbour_count;
+      } else {
+        auto [candidate, inserted] = insert(sparse.candidates, key);
+        if (sparse.colored) accumulate_color(candidate->color_sum, cell.color);
+        ++candidate->count;
+      }
+    }
+
+    // a cell with a survival count of neighbours lives on
+    if (rule::survives(active, neighbour_count)) cells.push_back(cell);
+  }
+
+  // and a dead cell with a birth count of live neighbours becomes a live cell
+  auto& candidates = sparse.candidates;
+  sparse.births.clear();
+  for (size_t slot = 0; slot < candidates.used.size(); ++slot) {
+    if (!candidates.used[slot]) continue;
+    int count = candidates.values[slot].count;
+    if (!rule::born(active, count)) continue;
+    sparse.births.emplace_back(candidates.keys[slot], sparse.colored ? blend_colors(candidates.values[slot].color_sum, count) : white);
+  }
+  std::ranges::sort(sparse.births, {}, &std::pair<uint64_t, color_t>::first);
+
+  for (const auto& [key, color] : sparse.births) cells.push_back(cell_t{unpack_coord(key), color});
+
+  profile::count(profile::counter_e::candidates, candidates.size);
+  profile::count(profile::counter_e::births, sparse.births.size());
+  profile::count(profile::counter_e::deaths, previous_cells.size() - (cells.size() - sparse.births.size()));
+}
+
+}  // namespace engine::sparse
\ No newline at end of file
@@ -0,0 +1,724 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Engine Tile Functions
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "engine_cell.hpp"
+#include "engine_pool.hpp"
+#include "engine_rule.hpp"
+#include "engine_sparse.hpp"
+#include "profile.hpp"
+
+namespace engine::tile {
+
+// tiles are 64x64 cells, one 64 bit word per row, bit n is column n
+constexpr int tile_shift = 6;
+constexpr int tile_size = 1 << tile_shift;
+constexpr int tile_mask = tile_size - 1;
+
+constexpr uint32_t no_tile = ~0u;
+
+using rows_t = std::array<uint64_t, tile_size>;
+
+// how a tile produced its last generation
+enum struct activity_e : uint8_t { computed, copied, held };
+
+struct tile_t {
+  int x, y;
+
+  // rows are double buffered, the current generation lives in rows[parity]
+  std::array<rows_t, 2> rows;
+
+  // neighbouring tile indices in neighbour_deltas order
+  std::array<uint32_t, 8> neighbours;
+
+  // change tracking, buffered by parity like the rows
+  // stable when a generation equals the one before, cycling when it equals the one two before
+  std::array<bool, 2> stable;
+  std::array<bool, 2> cycling;
+
+  activity_e activity;
+  bool woken;
+  int empty_generations;
+};
+
+// colours live beside the bits, one byte per cell per channel and dead cells zero,
+// so a sum over all eight neighbours is the sum over the live ones
+using channel_t = std::array<uint8_t, tile_size * tile_size>;
+
+struct plane_t {
+  // buffered by parity like the rows
+  std::array<std::array<channel_t, 3>, 2> channels;
+};
+
+struct tiles_t {
+  std::vector<tile_t> tiles;
+  sparse::table_t<uint32_t> index;
+
+  // planes[n] belongs to tiles[n], empty when the tiles are colourless
+  bool colored{true};
+  std::vector<plane_t> planes;
+
+  rule::rule_t rule{rule::conway};
+
+  int parity{0};
+
+  size_t allocated{0};
+  size_t freed{0};
+
+  // tiles computed and skipped in the last generation, and skipped tiles woken by a changing neighbour
+  size_t computed{0};
+  size_t skipped{0};
+  size_t woken{0};
+
+  uint64_t total_computed{0};
+  uint64_t total_skipped{0};
+  uint64_t total_woken{0};
+};
+
+auto tile_key(const int tile_x, const int tile_y) -> uint64_t { return pack_coord(tile_x, tile_y); }
+
+auto find_tile(tiles_t& tiles, const int tile_x, const int tile_y) -> uint32_t {
+  auto found = sparse::find(tiles.index, tile_key(tile_x, tile_y));
+  return found != nullptr ? *found : no_tile;
+}
+
+// neighbour links are left stale, relink once a batch of tiles has been added
+// a quiet tile is known to have been empty for the last two generations
+auto ensure_tile(tiles_t& tiles, const int tile_x, const int tile_y, const bool quiet = false) -> uint32_t {
+  auto [found, inserted] = sparse::insert(tiles.index, tile_key(tile_x, tile_y));
+  if (!inserted) return *found;
+
+  *found = static_cast<uint32_t>(tiles.tiles.size());
+
+  if (tiles.tiles.size() == tiles.tiles.capacity()) profile::count(profile::counter_e::allocations);
+  tile_t& tile = tiles.tiles.emplace_back();
+  tile.x = tile_x;
+  tile.y = tile_y;
+  tile.rows[0].fill(0);
+  tile.rows[1].fill(0);
+  tile.neighbours.fill(no_tile);
+  tile.stable.fill(quiet);
+  tile.cycling.fill(quiet);
+  tile.activity = activity_e::computed;
+  tile.woken = false;
+  tile.empty_generations = 0;
+  if (tiles.colored) tiles.planes.emplace_back();
+  ++tiles.allocated;
+  return *found;
+}
+
+auto relink(tiles_t& tiles) -> void {
+  sparse::clear(tiles.index);
+  sparse::reserve(tiles.index, tiles.tiles.size());
+  for (uint32_t index = 0; index < tiles.tiles.size(); ++index) *sparse::insert(tiles.index, tile_key(tiles.tiles[index].x, tiles.tiles[index].y)).first = index;
+
+  for (auto& tile : tiles.tiles) {
+    for (int direction = 0; const auto& [delta_x, delta_y] : neighbour_deltas) tile.neighbours[direction++] = find_tile(tiles, tile.x + delta_x, tile.y + delta_y);
+  }
+}
+
+auto clear(tiles_t& tiles) -> void {
+  tiles.freed += tiles.tiles.size();
+  tiles.tiles.clear();
+  tiles.planes.clear();
+  sparse::clear(tiles.index);
+}
+
+auto set_cell(tiles_t& tiles, const int x, const int y, const color_t& color) -> void {
+  uint32_t index = ensure_tile(tiles, x >> tile_shift, y >> tile_shift);
+  tiles.tiles[index].rows[tiles.parity][y & tile_mask] |= uint64_t{1} << (x & tile_mask);
+
+  if (!tiles.colored) return;
+  auto& channels = tiles.planes[index].channels[tiles.parity];
+  for (int channel = 0; channel < 3; ++channel) channels[channel][(y & tile_mask) * tile_size + (x & tile_mask)] = color[channel];
+}
+
+auto load(tiles_t& tiles, const std::vector<cell_t>& cells) -> void {
+  clear(tiles);
+  for (const auto& cell : cells) set_cell(tiles, cell.coord.first, cell.coord.second, cell.color);
+  relink(tiles);
+}
+
+template <typename function_t>
+auto for_each_cell(const tiles_t& tiles, function_t&& function) -> void {
+  for (const auto& tile : tiles.tiles) {
+    const auto& rows = tile.rows[tiles.parity];
+    for (int row = 0; row < tile_size; ++row) {
+      for (uint64_t word = rows[row]; word != 0; word &= word - 1) function((tile.x << tile_shift) + std::countr_zero(word), (tile.y << tile_shift) + row);
+    }
+  }
+}
+
+template <typename function_t>
+auto for_each_colored_cell(const tiles_t& tiles, function_t&& function) -> void {
+  for (size_t index = 0; index < tiles.tiles.size(); ++index) {
+    const auto& tile = tiles.tiles[index];
+    const auto& rows = tile.rows[tiles.parity];
+    const auto& channels = tiles.planes[index].channels[tiles.parity];
+    for (int row = 0; row < tile_size; ++row) {
+      for (uint64_t word = rows[row]; word != 0; word &= word - 1) {
+        int column = std::countr_zero(word);
+        int cell = row * tile_size + column;
+        function((tile.x << tile_shift) + column, (tile.y << tile_shift) + row, color_t{channels[0][cell], channels[1][cell], channels[2][cell]});
+      }
+    }
+  }
+}
+
+auto population(const tiles_t& tiles) -> size_t {
+  size_t count = 0;
+  for (const auto& tile : tiles.tiles)
+    for (const auto word : tile.rows[tiles.parity]) count += std::popcount(word);
+  return count;
+}
+
+// Lane Functions -------------------------------
+// the word-parallel adders are written once against these and instantiated
+// for the widest instruction set the build targets
+struct scalar_lanes_t {
+  using vector_t = uint64_t;
+  static constexpr int width = 1;
+
+  static auto load(const uint64_t* words) -> vector_t { return *words; }
+  static auto store(uint64_t* words, vector_t v) -> void { *words = v; }
+  static auto bit_and(vector_t a, vector_t b) -> vector_t { return a & b; }
+  static auto bit_or(vector_t a, vector_t b) -> vector_t { return a | b; }
+  static auto bit_xor(vector_t a, vector_t b) -> vector_t { return a ^ b; }
+  static auto bit_andnot(vector_t a, vector_t b) -> vector_t { return ~a & b; }
+  static auto zero() -> vector_t { return 0; }
+  static auto fill() -> vector_t { return ~uint64_t{0}; }
+  template <int n> static auto left(vector_t v) -> vector_t { return v << n; }
+  template <int n> static auto right(vector_t v) -> vector_t { return v >> n; }
+};
+
+#if defined(__SSE2__)
+struct sse2_lanes_t {
+  using vector_t = __m128i;
+  static constexpr int width = 2;
+
+  static auto load(const uint64_t* words) -> vector_t { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(words)); }
+  static auto store(uint64_t* words, vector_t v) -> void { _mm_storeu_si128(reinterpret_cast<__m128i*>(words), v); }
+  static auto bit_and(vector_t a, vector_t b) -> vector_t { return _mm_and_si128(a, b); }
+  static auto bit_or(vector_t a, vector_t b) -> vector_t { return _mm_or_si128(a, b); }
+  static auto bit_xor(vector_t a, vector_t b) -> vector_t { return _mm_xor_si128(a, b); }
+  static auto bit_andnot(vector_t a, vector_t b) -> vector_t { return _mm_andnot_si128(a, b); }
+  static auto zero() -> vector_t { return _mm_setzero_si128(); }
+  static auto fill() -> vector_t { return _mm_set1_epi64x(-1); }
+  template <int n> static auto left(vector_t v) -> vector_t { return _mm_slli_epi64(v, n); }
+  template <int n> static auto right(vector_t v) -> vector_t { return _mm_srli_epi64(v, n); }
+};
+#endif
+
+#if defined(__AVX2__)
+struct avx2_lanes_t {
+  using vector_t = __m256i;
+  static constexpr int width = 4;
+
+  static auto load(const uint64_t* words) -> vector_t { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words)); }
+  static auto store(uint64_t* words, vector_t v) -> void { _mm256_storeu_si256(reinterpret_cast<__m256i*>(words), v); }
+  static auto bit_and(vector_t a, vector_t b) -> vector_t { return _mm256_and_si256(a, b); }
+  static auto bit_or(vector_t a, vector_t b) -> vector_t { return _mm256_or_si256(a, b); }
+  static auto bit_xor(vector_t a, vector_t b) -> vector_t { return _mm256_xor_si256(a, b); }
+  static auto bit_andnot(vector_t a, vector_t b) -> vector_t { return _mm256_andnot_si256(a, b); }
+  static auto zero() -> vector_t { return _mm256_setzero_si256(); }
+  static auto fill() -> vector_t { return _mm256_set1_epi64x(-1); }
+  template <int n> static auto left(vector_t v) -> vector_t { return _mm256_slli_epi64(v, n); }
+  template <int n> static auto right(vector_t v) -> vector_t { return _mm256_srli_epi64(v, n); }
+};
+#endif
+
+#if defined(__AVX2__)
+using lanes_t = avx2_lanes_t;
+#elif defined(__SSE2__)
+using lanes_t = sse2_lanes_t;
+#else
+using lanes_t = scalar_lanes_t;
+#endif
+// ----------------------------------------------
+
+// a tile plus its one cell halo, row n of the tile is index n + 1
+struct halo_t {
+  std::array<uint64_t, tile_size + 2> centre;
+  std::array<uint64_t, tile_size + 2> west;
+  std::array<uint64_t, tile_size + 2> east;
+};
+
+auto gather_halo(const tiles_t& tiles, const tile_t& tile, halo_t& halo) -> void {
+  static const rows_t empty_rows{};
+
+  auto rows_of = [&](const int direction) -> const rows_t& {
+    uint32_t index = tile.neighbours[direction];
+    return index != no_tile ? tiles.tiles[index].rows[tiles.parity] : empty_rows;
+  };
+
+  const rows_t& rows = tile.rows[tiles.parity];
+  const rows_t& north = rows_of(0);
+  const rows_t& north_east = rows_of(1);
+  const rows_t& east = rows_of(2);
+  const rows_t& south_east = rows_of(3);
+  const rows_t& south = rows_of(4);
+  const rows_t& south_west = rows_of(5);
+  const rows_t& west = rows_of(6);
+  const rows_t& north_west = rows_of(7);
+
+  std::ranges::copy(rows, std::begin(halo.centre) + 1);
+  std::ranges::copy(west, std::begin(halo.west) + 1);
+  std::ranges::copy(east, std::begin(halo.east) + 1);
+
+  halo.centre.front() = north.back();
+  halo.centre.back() = south.front();
+  halo.west.front() = north_west.back();
+  halo.west.back() = south_west.front();
+  halo.east.front() = north_east.back();
+  halo.east.back() = south_east.front();
+}
+
+// computes the rule for the 64 rows of a tile from its halo, conway only needs to know whether
+// the count is 2 or 3 while every other rule sums the full count into four bit planes
+template <typename lanes_t, rule::packed_t packed>
+auto step_rows(const halo_t& halo, rows_t& next, const rule::rule_t runtime_rule) -> void {
+  using L = lanes_t;
+  using vector_t = typename L::vector_t;
+  const rule::rule_t active = rule::resolve<packed>(runtime_rule);
+
+  // west, centre and east neighbours of one line of the halo
+  auto line = [&](const int index, vector_t& l, vector_t& c, vector_t& r) -> void {
+    c = L::load(&halo.centre[index]);
+    l = L::bit_or(L::template left<1>(c), L::template right<63>(L::load(&halo.west[index])));
+    r = L::bit_or(L::template right<1>(c), L::template left<63>(L::load(&halo.east[index])));
+  };
+
+  for (int row = 0; row < tile_size; row += L::width) {
+    vector_t above_l, above_c, above_r;
+    vector_t middle_l, middle_c, middle_r;
+    vector_t below_l, below_c, below_r;
+    line(row, above_l, above_c, above_r);
+    line(row + 1, middle_l, middle_c, middle_r);
+    line(row + 2, below_l, below_c, below_r);
+
+    // sum each line into ones and twos
+    vector_t above_x = L::bit_xor(above_l, above_c);
+    vector_t above_0 = L::bit_xor(above_x, above_r);
+    vector_t above_1 = L::bit_or(L::bit_and(above_l, above_c), L::bit_and(above_x, above_r));
+
+    vector_t middle_0 = L::bit_xor(middle_l, middle_r);
+    vector_t middle_1 = L::bit_and(middle_l, middle_r);
+
+    vector_t below_x = L::bit_xor(below_l, below_c);
+    vector_t below_0 = L::bit_xor(below_x, below_r);
+    vector_t below_1 = L::bit_or(L::bit_and(below_l, below_c), L::bit_and(below_x, below_r));
+
+    // sum the ones, carrying into the twos
+    vector_t ones_x = L::bit_xor(above_0, middle_0);
+    vector_t ones = L::bit_xor(ones_x, below_0);
+    vector_t ones_1 = L::bit_or(L::bit_and(above_0, middle_0), L::bit_and(ones_x, below_0));
+
+    vector_t twos_a = L::bit_xor(above_1, middle_1);
+    vector_t twos_b = L::bit_xor(below_1, ones_1);
+
+    if constexpr (packed == rule::pack(rule::conway)) {
+      // exactly one of the four twos is set when the count is 2 or 3
+      vector_t twos_pairs = L::bit_or(L::bit_and(above_1, middle_1), L::bit_and(below_1, ones_1));
+      vector_t one_two = L::bit_andnot(twos_pairs, L::bit_xor(twos_a, twos_b));
+
+      L::store(&next[row], L::bit_and(one_two, L::bit_or(ones, middle_c)));
+    } else {
+      // sum the four twos, carrying into the fours and eights
+      vector_t twos_a_1 = L::bit_and(above_1, middle_1);
+      vector_t twos_b_1 = L::bit_and(below_1, ones_1);
+      vector_t twos = L::bit_xor(twos_a, twos_b);
+      vector_t fours = L::bit_xor(L::bit_xor(twos_a_1, twos_b_1), L::bit_and(twos_a, twos_b));
+      vector_t eights = L::bit_and(twos_a_1, twos_b_1);
+
+      // decode the count, the cells whose count is n are low[n & 3] and high[n >> 2]
+      const vector_t low[4]{L::bit_andnot(L::bit_or(ones, twos), L::fill()), L::bit_andnot(twos, ones), L::bit_andnot(ones, twos), L::bit_and(ones, twos)};
+      const vector_t high[3]{L::bit_andnot(L::bit_or(fours, eights), L::fill()), L::bit_andnot(eights, fours), eights};
+
+      // unrolled so that a specialised rule keeps only the counts it uses
+      vector_t births = L::zero();
+      vector_t survivors = L::zero();
+      auto accumulate = [&]<int... counts>(std::integer_sequence<int, counts...>) {
+        auto count = [&](const int n) {
+          if (!rule::born(active, n) && !rule::survives(active, n)) return;
+          vector_t matched = L::bit_and(low[n & 3], high[n >> 2]);
+          if (rule::born(active, n)) births = L::bit_or(births, matched);
+          if (rule::survives(active, n)) survivors = L::bit_or(survivors, matched);
+        };
+        (count(counts), ...);
+      };
+      accumulate(std::make_integer_sequence<int, 9>());
+
+      L::store(&next[row], L::bit_or(L::bit_andnot(middle_c, births), L::bit_and(middle_c, survivors)));
+    }
+  }
+}
+
+// Blend Functions ------------------------------
+// births take a third of the channel sum over all eight neighbours, survivors keep their
+// colour and everything else is cleared, 64 cells of one channel at a time
+// rules that are born on other counts divide each birth by its own count instead
+constexpr int halo_size = tile_size + 2;
+
+using color_halo_t = std::array<uint8_t, halo_size * halo_size>;
+
+// byte n of masks[b] is 0xFF when bit n of b is set
+static const std::array<uint64_t, 256> byte_masks = [] {
+  std::array<uint64_t, 256> masks{};
+  for (int bits = 0; bits < 256; ++bits) {
+    for (int bit = 0; bit < 8; ++bit) masks[bits] |= (bits >> bit & 1) ? uint64_t{0xFF} << (bit * 8) : 0;
+  }
+  return masks;
+}();
+
+auto expand_bits(const uint64_t word, uint8_t* bytes) -> void {
+  for (int byte = 0; byte < 8; ++byte) std::memcpy(bytes + byte * 8, &byte_masks[(word >> (byte * 8)) & 0xFF], 8);
+}
+
+// above, middle and below start at the west halo column of their rows
+auto blend_row_scalar(const uint8_t* above, const uint8_t* middle, const uint8_t* below, const uint8_t* born, const uint8_t* kept, uint8_t* out) -> void {
+  for (int x = 0; x < tile_size; ++x) {
+    uint32_t sum = above[x] + above[x + 1] + above[x + 2] + middle[x] + middle[x + 2] + below[x] + below[x + 1] + below[x + 2];
+    out[x] = static_cast<uint8_t>((third(sum) & born[x]) | (middle[x + 1] & kept[x]));
+  }
+}
+
+#if defined(__SSE2__)
+auto blend_row_sse2(const uint8_t* above, const uint8_t* middle, const uint8_t* below, const uint8_t* born, const uint8_t* kept, uint8_t* out) -> void {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i divisor = _mm_set1_epi16(21846);
+  auto widen = [&](const uint8_t* bytes) { return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(bytes)), zero); };
+  auto load = [](const uint8_t* bytes) { return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(bytes)); };
+
+  for (int x = 0; x < tile_size; x += 8) {
+    __m128i sum = _mm_add_epi16(_mm_add_epi16(widen(above + x), widen(above + x + 1)), _mm_add_epi16(widen(above + x + 2), widen(middle + x)));
+    sum = _mm_add_epi16(sum, _mm_add_epi16(_mm_add_epi16(widen(middle + x + 2), widen(below + x)), _mm_add_epi16(widen(below + x + 1), widen(below + x + 2))));
+    __m128i thirds = _mm_packus_epi16(_mm_mulhi_epu16(sum, divisor), zero);
+    __m128i result = _mm_or_si128(_mm_and_si128(thirds, load(born + x)), _mm_and_si128(load(middle + x + 1), load(kept + x)));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + x), result);
+  }
+}
+#endif
+
+#if defined(__AVX2__)
+auto blend_row_avx2(const uint8_t* above, const uint8_t* middle, const uint8_t* below, const uint8_t* born, const uint8_t* kept, uint8_t* out) -> void {
+  const __m256i divisor = _mm256_set1_epi16(21846);
+  auto widen = [](const uint8_t* bytes) { return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes))); };
+  auto load = [](const uint8_t* bytes) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes)); };
+
+  for (int x = 0; x < tile_size; x += 16) {
+    __m256i sum = _mm256_add_epi16(_mm256_add_epi16(widen(above + x), widen(above + x + 1)), _mm256_add_epi16(widen(above + x + 2), widen(middle + x)));
+    sum = _mm256_add_epi16(sum, _mm256_add_epi16(_mm256_add_epi16(widen(middle + x + 2), widen(below + x)), _mm256_add_epi16(widen(below + x + 1), widen(below + x + 2))));
+
+    // packus interleaves the 128 bit halves, the permute brings the 16 bytes together
+    __m256i packed = _mm256_packus_epi16(_mm256_mulhi_epu16(sum, divisor), _mm256_setzero_si256());
+    __m128i thirds = _mm256_castsi256_si128(_mm256_permute4x64_epi64(packed, 0b1000));
+    __m128i result = _mm_or_si128(_mm_and_si128(thirds, load(born + x)), _mm_and_si128(load(middle + x + 1), load(kept + x)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), result);
+  }
+}
+#endif
+
+auto blend_row(const uint8_t* above, const uint8_t* middle, const uint8_t* below, const uint8_t* born, const uint8_t* kept, uint8_t* out) -> void {
+#if defined(__AVX2__)
+  blend_row_avx2(above, middle, below, born, kept, out);
+#elif defined(__SSE2__)
+  blend_row_sse2(above, middle, below, born, kept, out);
+#else
+  blend_row_scalar(above, middle, below, born, kept, out);
+#endif
+}
+
+auto blend_row_counted(const uint8_t* above, const uint8_t* middle, const uint8_t* below, const uint8_t* counts, const uint8_t* born, const uint8_t* kept, uint8_t* out) -> void {
+  for (int x = 0; x < tile_size; ++x) {
+    uint32_t sum = above[x] + above[x + 1] + above[x + 2] + middle[x] + middle[x + 2] + below[x] + below[x + 1] + below[x + 2];
+    uint8_t birth = born[x] ? static_cast<uint8_t>(sum / counts[x]) : 0;
+    out[x] = static_cast<uint8_t>(birth | (middle[x + 1] & kept[x]));
+  }
+}
+
+// live neighbour counts of the cells in one row of the tile
+auto count_neighbours(const halo_t& halo, const int row, uint8_t* counts) -> void {
+  std::fill_n(counts, tile_size, 0);
+  for (int line = row; line < row + 3; ++line) {
+    uint64_t centre = halo.centre[line];
+    uint64_t west = centre << 1 | halo.west[line] >> 63;
+    uint64_t east = centre >> 1 | halo.east[line] << 63;
+    for (int x = 0; x < tile_size; ++x) counts[x] += (west >> x & 1) + (east >> x & 1) + (line != row + 1 ? centre >> x & 1 : 0);
+  }
+}
+
+auto gather_color_halo(const tiles_t& tiles, const tile_t& tile, const channel_t& own, const int channel, color_halo_t& halo) -> void {
+  auto channel_of = [&](const int direction) -> const channel_t* {
+    uint32_t index = tile.neighbours[direction];
+    return index != no_tile ? &tiles.planes[index].channels[tiles.parity][channel] : nullptr;
+  };
+  auto cell_of = [](const channel_t* cells, const int row, const int column) -> uint8_t { return cells != nullptr ? (*cells)[row * tile_size + column] : 0; };
+
+  const channel_t* north = channel_of(0);
+  const channel_t* south = channel_of(4);
+  const channel_t* east = channel_of(2);
+  const channel_t* west = channel_of(6);
+
+  for (int row = 0; row < tile_size; ++row) {
+    uint8_t* line = &halo[(row + 1) * halo_size];
+    line[0] = cell_of(west, row, tile_mask);
+    std::memcpy(line + 1, &own[row * tile_size], tile_size);
+    line[halo_size - 1] = cell_of(east, row, 0);
+  }
+
+  uint8_t* top = &halo[0];
+  uint8_t* bottom = &halo[(halo_size - 1) * halo_size];
+  top[0] = cell_of(channel_of(7), tile_mask, tile_mask);
+  top[halo_size - 1] = cell_of(channel_of(1), tile_mask, 0);
+  bottom[0] = cell_of(channel_of(5), 0, tile_mask);
+  bottom[halo_size - 1] = cell_of(channel_of(3), 0, 0);
+  if (north != nullptr)
+    std::memcpy(top + 1, &(*north)[tile_mask * tile_size], tile_size);
+  else
+    std::memset(top + 1, 0, tile_size);
+  if (south != nullptr)
+    std::memcpy(bottom + 1, &(*south)[0], tile_size);
+  else
+    std::memset(bottom + 1, 0, tile_size);
+}
+
+// writes the colours of the next generation given its rows, only rows with births pay for the neighbour sums
+template <rule::packed_t packed>
+auto blend_tile(const tiles_t& tiles, const uint32_t index, const rows_t& next_rows, plane_t& plane) -> void {
+  const rule::rule_t active = rule::resolve<packed>(tiles.rule);
+  const bool thirds = active.birth == 1 << 3;
+
+  const tile_t& tile = tiles.tiles[index];
+  const rows_t& rows = tile.rows[tiles.parity];
+  const auto& channels = plane.channels[tiles.parity];
+  auto& next_channels = plane.channels[tiles.parity ^ 1];
+
+  bool births = false;
+  for (int row = 0; row < tile_size; ++row) births |= (next_rows[row] & ~rows[row]) != 0;
+
+  alignas(64) std::array<uint8_t, tile_size> born;
+  alignas(64) std::array<uint8_t, tile_size> kept;
+  color_halo_t halo;
+
+  // the parent counts are the same for every channel
+  std::array<uint8_t, tile_size * tile_size> counts;
+  if (births && !thirds) {
+    halo_t bits;
+    gather_halo(tiles, tile, bits);
+    for (int row = 0; row < tile_size; ++row)
+      if ((next_rows[row] & ~rows[row]) != 0) count_neighbours(bits, row, &counts[row * tile_size]);
+  }
+
+  for (int channel = 0; channel < 3; ++channel) {
+    const channel_t& own = channels[channel];
+    channel_t& out = next_channels[channel];
+    if (births) gather_color_halo(tiles, tile, own, channel, halo);
+
+    for (int row = 0; row < tile_size; ++row) {
+      uint64_t born_word = next_rows[row] & ~rows[row];
+      uint64_t kept_word = next_rows[row] & rows[row];
+      expand_bits(kept_word, kept.data());
+
+      if (born_word == 0) {
+        for (int x = 0; x < tile_size; ++x) out[row * tile_size + x] = own[row * tile_size + x] & kept[x];
+        continue;
+      }
+
+      expand_bits(born_word, born.data());
+      if (thirds)
+        blend_row(&halo[row * halo_size], &halo[(row + 1) * halo_size], &halo[(row + 2) * halo_size], born.data(), kept.data(), &out[row * tile_size]);
+      else
+        blend_row_counted(&halo[row * halo_size], &halo[(row + 1) * halo_size], &halo[(row + 2) * halo_size], &counts[row * tile_size], born.data(), kept.data(), &out[row * tile_size]);
+    }
+  }
+}
+// ----------------------------------------------
+
+// ensures a tile exists beside every live edge so births can spill over
+auto expand(tiles_t& tiles) -> void {
+  size_t count = tiles.tiles.size();
+  size_t expanded = count;
+
+  for (size_t index = 0; index < count; ++index) {
+    const rows_t& rows = tiles.tiles[index].rows[tiles.parity];
+
+    uint64_t west_column = 0;
+    uint64_t east_column = 0;
+    for (const auto word : rows) {
+      west_column |= word & 1;
+      east_column |= word >> 63;
+    }
+
+    std::array<bool, 8> needed;
+    needed[0] = rows.front() != 0;
+    needed[1] = (rows.front() >> 63) != 0;
+    needed[2] = east_column != 0;
+    needed[3] = (rows.back() >> 63) != 0;
+    needed[4] = rows.back() != 0;
+    needed[5] = (rows.back() & 1) != 0;
+    needed[6] = west_column != 0;
+    needed[7] = (rows.front() & 1) != 0;
+
+    int tile_x = tiles.tiles[index].x;
+    int tile_y = tiles.tiles[index].y;
+    for (int direction = 0; const auto& [delta_x, delta_y] : neighbour_deltas) {
+      if (needed[direction++]) ensure_tile(tiles, tile_x + delta_x, tile_y + delta_y, true);
+    }
+  }
+
+  if (tiles.tiles.size() != expanded) relink(tiles);
+}
+
+// removes tiles that have been empty for three generations and border no live tile,
+// so a missing tile always reads as empty, stable and cycling to its neighbours
+auto shrink(tiles_t& tiles) -> void {
+  auto empty = [&](const tile_t& tile) -> bool { return std::ranges::all_of(tile.rows[tiles.parity], [](const uint64_t word) { return word == 0; }); };
+
+  bool any_expired = false;
+  for (auto& tile : tiles.tiles) {
+    tile.empty_generations = empty(tile) ? tile.empty_generations + 1 : 0;
+    any_expired |= tile.empty_generations >= 3;
+  }
+  if (!any_expired) return;
+
+  auto expired = [&](const tile_t& tile) -> bool {
+    if (tile.empty_generations < 3) return false;
+    return std::ranges::all_of(tile.neighbours, [&](const uint32_t index) { return index == no_tile || tiles.tiles[index].empty_generations != 0; });
+  };
+
+  // decide before erasing, the erase moves tiles and invalidates the neighbour indices
+  for (auto& tile : tiles.tiles) tile.empty_generations = expired(tile) ? -1 : tile.empty_generations;
+
+  // the planes are compacted alongside their tiles
+  size_t kept = 0;
+  for (size_t index = 0; index < tiles.tiles.size(); ++index) {
+    if (tiles.tiles[index].empty_generations < 0) continue;
+    if (kept != index) {
+      tiles.tiles[kept] = tiles.tiles[index];
+      if (tiles.colored) tiles.planes[kept] = tiles.planes[index];
+    }
+    ++kept;
+  }
+
+  size_t erased = tiles.tiles.size() - kept;
+  if (erased == 0) return;
+  tiles.tiles.resize(kept);
+  if (tiles.colored) tiles.planes.resize(kept);
+
+  tiles.freed += erased;
+  relink(tiles);
+}
+
+// a tile whose neighbourhood is unchanged since the last generation keeps its rows, and
+// one whose neighbourhood matches two generations ago returns to the rows it held then
+// held tiles still blend, their births recur but the parent colours need not, while a
+// copied tile was already stable so its next plane already holds the current colours
+template <rule::packed_t packed>
+auto step_tile(tiles_t& tiles, const uint32_t index) -> void {
+  tile_t& tile = tiles.tiles[index];
+  int current = tiles.parity;
+  int next = tiles.parity ^ 1;
+
+  bool stable = tile.stable[current];
+  bool cycling = tile.cycling[current];
+  for (const auto neighbour : tile.neighbours) {
+    if (neighbour == no_tile) continue;
+    stable &= tiles.tiles[neighbour].stable[current];
+    cycling &= tiles.tiles[neighbour].cycling[current];
+  }
+
+  tile.woken = false;
+
+  if (cycling) {
+    if (tiles.colored) blend_tile<packed>(tiles, index, tile.rows[next], tiles.planes[index]);
+    tile.stable[next] = tile.stable[current];
+    tile.cycling[next] = true;
+    tile.activity = activity_e::held;
+    return;
+  }
+
+  if (stable) {
+    tile.rows[next] = tile.rows[current];
+    tile.stable[next] = true;
+    tile.cycling[next] = true;
+    tile.activity = activity_e::copied;
+    return;
+  }
+
+  halo_t halo;
+  gather_halo(tiles, tile, halo);
+
+  rows_t rows;
+  step_rows<lanes_t, packed>(halo, rows, tiles.rule);
+  if (tiles.colored) blend_tile<packed>(tiles, index, rows, tiles.planes[index]);
+
+  tile.stable[next] = rows == tile.rows[current];
+  tile.cycling[next] = rows == tile.rows[next];
+  tile.rows[next] = rows;
+  tile.woken = tile.activity != activity_e::computed;
+  tile.activity = activity_e::computed;
+}
+
+auto count_activity(tiles_t& tiles) -> void {
+  tiles.computed = 0;
+  tiles.skipped = 0;
+  tiles.woken = 0;
+  for (const auto& tile : tiles.tiles) {
+    bool computed = tile.activity == activity_e::computed;
+    tiles.computed += computed;
+    tiles.skipped += !computed;
+    tiles.woken += tile.woken;
+  }
+
+  tiles.total_computed += tiles.computed;
+  tiles.total_skipped += tiles.skipped;
+  tiles.total_woken += tiles.woken;
+}
+
+// births and deaths between the current and next rows, copied tiles never change
+auto count_changes(const tiles_t& tiles) -> void {
+  int current = tiles.parity;
+  int next = tiles.parity ^ 1;
+
+  uint64_t births = 0;
+  uint64_t deaths = 0;
+  for (const auto& tile : tiles.tiles) {
+    if (tile.activity == activity_e::copied) continue;
+    for (int row = 0; row < tile_size; ++row) {
+      births += std::popcount(tile.rows[next][row] & ~tile.rows[current][row]);
+      deaths += std::popcount(tile.rows[current][row] & ~tile.rows[next][row]);
+    }
+  }
+
+  profile::count(profile::counter_e::births, births);
+  profile::count(profile::counter_e::deaths, deaths);
+}
+
+// every tile only reads the current generation and writes its own next rows,
+// so tiles can be stepped in any order on any thread with identical results
+template <rule::packed_t packed>
+auto step(tiles_t& tiles, pool::pool_t& pool) -> void {
+  expand(tiles);
+  pool::parallel_for(pool, tiles.tiles.size(), [&](const size_t index) { step_tile<packed>(tiles, static_cast<uint32_t>(index)); }, 4);
+  count_activity(tiles);
+  if constexpr (profile::enabled) count_changes(tiles);
+
+  tiles.parity ^= 1;
+  shrink(tiles);
+}
+
+}  // namespace engine::tile
\ No newline at end of file
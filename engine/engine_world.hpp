@@ -0,0 +1,239 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Engine World Functions
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "engine_cell.hpp"
+#include "engine_pool.hpp"
+#include "engine_rule.hpp"
+#include "profile.hpp"
+
+namespace engine::world {
+
+// the plane is unbounded and stepped by the selected engine, a torus wraps its edges
+// around and a bounded world keeps everything beyond its edges dead
+enum struct topology_e : uint8_t { plane, torus, bounded };
+
+auto topology_name(const topology_e topology) -> std::string_view {
+  switch (topology) {
+    case topology_e::plane: return "plane";
+    case topology_e::torus: return "torus";
+    case topology_e::bounded: return "bounded";
+  }
+  return "";
+}
+
+auto parse_topology(std::string_view name, topology_e& topology) -> bool {
+  for (auto candidate : {topology_e::plane, topology_e::torus, topology_e::bounded}) {
+    if (topology_name(candidate) == name) {
+      topology = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+// a finite world spans [origin_x, origin_x + width) x [origin_y, origin_y + height) with the origin
+// placed so that coord (0, 0) sits in the middle, every cell is a byte in a buffer padded by one
+// ghost cell on each side so the neighbour sums never test for an edge
+struct world_t {
+  topology_e topology{topology_e::plane};
+  int width{0};
+  int height{0};
+  int origin_x{0};
+  int origin_y{0};
+  int stride{0};
+
+  bool colored{true};
+  rule::rule_t rule{rule::conway};
+
+  // both generations are allocated when the world is sized, cells[parity] is the current one
+  int parity{0};
+  std::array<std::vector<uint8_t>, 2> cells;
+  std::array<std::array<std::vector<uint8_t>, 3>, 2> channels;
+
+  // births and deaths per band of rows, summed after each generation
+  std::vector<std::array<uint64_t, 2>> changes;
+};
+
+constexpr int band_rows = 16;
+
+auto finite(const world_t& world) -> bool { return world.topology != topology_e::plane; }
+
+auto cell_index(const world_t& world, const int column, const int row) -> size_t { return static_cast<size_t>(row + 1) * world.stride + column + 1; }
+
+auto resize(world_t& world, const topology_e topology, const int width, const int height) -> void {
+  world.topology = topology;
+  world.width = finite(world) ? std::max(width, 1) : 0;
+  world.height = finite(world) ? std::max(height, 1) : 0;
+  world.origin_x = -(world.width / 2);
+  world.origin_y = -(world.height / 2);
+  world.stride = world.width + 2;
+  world.parity = 0;
+
+  size_t area = finite(world) ? static_cast<size_t>(world.stride) * (world.height + 2) : 0;
+  for (int parity = 0; parity < 2; ++parity) {
+    world.cells[parity].assign(area, 0);
+    for (auto& channel : world.channels[parity]) channel.assign(world.colored ? area : 0, 0);
+  }
+  world.changes.assign((world.height + band_rows - 1) / band_rows, {0, 0});
+}
+
+auto floor_mod(const int64_t value, const int64_t modulus) -> int {
+  int64_t remainder = value % modulus;
+  return static_cast<int>(remainder < 0 ? remainder + modulus : remainder);
+}
+
+// moves a coord onto a torus, false when it falls outside a bounded world
+auto confine(const world_t& world, int& x, int& y) -> bool {
+  if (world.topology == topology_e::torus) {
+    x = world.origin_x + floor_mod(int64_t{x} - world.origin_x, world.width);
+    y = world.origin_y + floor_mod(int64_t{y} - world.origin_y, world.height);
+    return true;
+  }
+  if (world.topology == topology_e::bounded) return x >= world.origin_x && x < world.origin_x + world.width && y >= world.origin_y && y < world.origin_y + world.height;
+  return true;
+}
+
+auto clear(world_t& world) -> void {
+  std::ranges::fill(world.cells[world.parity], 0);
+  for (auto& channel : world.channels[world.parity]) std::ranges::fill(channel, 0);
+}
+
+auto load(world_t& world, const std::vector<cell_t>& cells) -> void {
+  clear(world);
+  for (const auto& cell : cells) {
+    int x = cell.coord.first, y = cell.coord.second;
+    if (!confine(world, x, y)) continue;
+
+    size_t index = cell_index(world, x - world.origin_x, y - world.origin_y);
+    world.cells[world.parity][index] = 1;
+    if (!world.colored) continue;
+    for (int channel = 0; channel < 3; ++channel) world.channels[world.parity][channel][index] = cell.color[channel];
+  }
+}
+
+// a torus copies its opposite edges into the ghost cells, a bounded world leaves them dead
+auto fill_ghosts(std::vector<uint8_t>& buffer, const world_t& world) -> void {
+  const int stride = world.stride;
+  uint8_t* data = buffer.data();
+  for (int row = 1; row <= world.height; ++row) {
+    data[row * stride] = data[row * stride + world.width];
+    data[row * stride + world.width + 1] = data[row * stride + 1];
+  }
+  std::copy_n(data + static_cast<size_t>(world.height) * stride, stride, data);
+  std::copy_n(data + stride, stride, data + static_cast<size_t>(world.height + 1) * stride);
+}
+
+template <typename function_t>
+auto for_each_cell(const world_t& world, function_t&& function) -> void {
+  const auto& cells = world.cells[world.parity];
+  for (int row = 0; row < world.height; ++row) {
+    const uint8_t* line = cells.data() + cell_index(world, 0, row);
+    for (int column = 0; column < world.width; ++column)
+      if (line[column]) function(world.origin_x + column, world.origin_y + row);
+  }
+}
+
+template <typename function_t>
+auto for_each_colored_cell(const world_t& world, function_t&& function) -> void {
+  const auto& cells = world.cells[world.parity];
+  const auto& channels = world.channels[world.parity];
+  for (int row = 0; row < world.height; ++row) {
+    size_t begin = cell_index(world, 0, row);
+    for (int column = 0; column < world.width; ++column) {
+      size_t index = begin + column;
+      if (cells[index]) function(world.origin_x + column, world.origin_y + row, color_t{channels[0][index], channels[1][index], channels[2][index]});
+    }
+  }
+}
+
+// the next state is bit (count + 9 * alive) of the rule's birth and survival masks side by side
+template <rule::packed_t packed>
+auto step_band(world_t& world, const int band) -> void {
+  const rule::rule_t active = rule::resolve<packed>(world.rule);
+  const uint32_t table = uint32_t{active.birth} | uint32_t{active.survival} << 9;
+  const int stride = world.stride;
+
+  const uint8_t* current = world.cells[world.parity].data();
+  uint8_t* next = world.cells[world.parity ^ 1].data();
+  const auto& current_channels = world.channels[world.parity];
+  auto& next_channels = world.channels[world.parity ^ 1];
+
+  uint64_t births = 0, deaths = 0;
+  int end_row = std::min((band + 1) * band_rows, world.height);
+  for (int row = band * band_rows; row < end_row; ++row) {
+    size_t begin = cell_index(world, 0, row);
+    const uint8_t* above = current + begin - stride;
+    const uint8_t* middle = current + begin;
+    const uint8_t* below = current + begin + stride;
+    uint8_t* out = next + begin;
+
+    for (int column = 0; column < world.width; ++column) {
+      int count = above[column - 1] + above[column] + above[column + 1] + middle[column - 1] + middle[column + 1] + below[column - 1] + below[column] + below[column + 1];
+      out[column] = static_cast<uint8_t>(table >> (count + 9 * middle[column]) & 1);
+    }
+
+    if constexpr (profile::enabled) {
+      for (int column = 0; column < world.width; ++column) {
+        births += out[column] & ~middle[column] & 1;
+        deaths += middle[column] & ~out[column] & 1;
+      }
+    }
+
+    if (!world.colored) continue;
+
+    // survivors keep their colour, births take the mean colour of their parents
+    for (int column = 0; column < world.width; ++column) {
+      size_t index = begin + column;
+      if (!out[column]) {
+        for (int channel = 0; channel < 3; ++channel) next_channels[channel][index] = 0;
+      } else if (middle[column]) {
+        for (int channel = 0; channel < 3; ++channel) next_channels[channel][index] = current_channels[channel][index];
+      } else {
+        color_sum_t sum{0, 0, 0};
+        int count = 0;
+        for (const auto& [delta_x, delta_y] : neighbour_deltas) {
+          size_t parent = index + static_cast<ptrdiff_t>(delta_y) * stride + delta_x;
+          if (!current[parent]) continue;
+          for (int channel = 0; channel < 3; ++channel) sum[channel] += current_channels[channel][parent];
+          ++count;
+        }
+        color_t color = blend_colors(sum, count);
+        for (int channel = 0; channel < 3; ++channel) next_channels[channel][index] = color[channel];
+      }
+    }
+  }
+
+  world.changes[band] = {births, deaths};
+}
+
+template <rule::packed_t packed>
+auto step(world_t& world, pool::pool_t& pool) -> void {
+  if (world.topology == topology_e::torus) {
+    fill_ghosts(world.cells[world.parity], world);
+    if (world.colored)
+      for (auto& channel : world.channels[world.parity]) fill_ghosts(channel, world);
+  }
+
+  pool::parallel_for(pool, world.changes.size(), [&](const size_t band) { step_band<packed>(world, static_cast<int>(band)); });
+  world.parity ^= 1;
+
+  if constexpr (profile::enabled) {
+    for (const auto& [births, deaths] : world.changes) {
+      profile::count(profile::counter_e::births, births);
+      profile::count(profile::counter_e::deaths, deaths);
+    }
+  }
+}
+
+}  // namespace engine::world
@@ -4,6 +4,10 @@
 //
 
 #include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <utility>
 #include <vector>
 
 #include "display.hpp"
@@ -23,6 +27,36 @@ struct grid_offset_t {
   }
 };
 
+// a torus repeats every width x height cells starting from its origin, zero never wraps
+struct grid_wrap_t {
+  int width{0};
+  int height{0};
+  int origin_x{0};
+  int origin_y{0};
+};
+
+// the grid to display transform, the window size is only queried after a window event
+struct grid_viewport_t {
+  bool stale{true};
+
+  int window_width{0};
+  int window_height{0};
+
+  int cell_size{0};
+  int zoom_shift{0};
+  grid_offset_t offset{0, 0};
+
+  // display position of coord (0, 0)
+  int origin_x{0};
+  int origin_y{0};
+
+  // coords of the cells intersecting the window, inclusive, at every zoom
+  int min_x{0};
+  int min_y{0};
+  int max_x{-1};
+  int max_y{-1};
+};
+
 struct grid_t {
   int subdivisions{1};
 
@@ -31,12 +65,21 @@ struct grid_t {
 
   int cell_size{0};
 
+  // below one pixel per cell each pixel covers 2^zoom_shift x 2^zoom_shift cells
+  int zoom_shift{0};
+
   grid_offset_t offset;
 
   int cursor_x{0};
   int cursor_y{0};
+
+  grid_wrap_t wrap;
+
+  grid_viewport_t viewport;
 };
 
+constexpr int grid_max_zoom_shift = 20;
+
 auto grid_max_subdivisions(const display::display_t& display, const grid_t& grid) -> int {
   int window_width, window_height;
   SDL_GetWindowSize(display.window, &window_width, &window_height);
@@ -52,6 +95,42 @@ auto grid_max_subdivisions(const display::display_t& display, const grid_t& grid
   return std::min(width_subdivisions, height_subdivisions);
 }
 
+auto floor_div(const int64_t numerator, const int64_t denominator) -> int64_t {
+  int64_t quotient = numerator / denominator;
+  return (numerator % denominator != 0 && (numerator < 0) != (denominator < 0)) ? quotient - 1 : quotient;
+}
+
+auto wrap_grid_coord(const int coord, const int period, const int origin) -> int {
+  if (period <= 0) return coord;
+  int64_t relative = int64_t{coord} - origin;
+  return static_cast<int>(origin + relative - floor_div(relative, period) * period);
+}
+
+auto wrap_grid_coord_x(const grid_t& grid, const int coord_x) -> int { return wrap_grid_coord(coord_x, grid.wrap.width, grid.wrap.origin_x); }
+
+auto wrap_grid_coord_y(const grid_t& grid, const int coord_y) -> int { return wrap_grid_coord(coord_y, grid.wrap.height, grid.wrap.origin_y); }
+
+// the copies of a wrapped axis whose cells fall within [min, max], just the one when it does not wrap
+auto grid_wrap_copies(const int min, const int max, const int period, const int origin) -> std::pair<int, int> {
+  if (period <= 0) return {0, 0};
+  return {static_cast<int>(floor_div(int64_t{min} - origin, period)), static_cast<int>(floor_div(int64_t{max} - origin, period))};
+}
+
+// the wrap period in display pixels, zero when it is not a whole number of pixels
+auto grid_wrap_pixels(const grid_t& grid, const int period) -> int64_t {
+  int64_t span = int64_t{period} * grid.cell_size;
+  if (span % (int64_t{1} << grid.zoom_shift) != 0) return 0;
+  return span >> grid.zoom_shift;
+}
+
+// panning on a torus loops, the offset stays within one period of the origin
+auto wrap_grid_offset(grid_t& grid) -> void {
+  int64_t width = grid_wrap_pixels(grid, grid.wrap.width);
+  int64_t height = grid_wrap_pixels(grid, grid.wrap.height);
+  if (width > 0) grid.offset.x = static_cast<int>(grid.offset.x - floor_div(grid.offset.x, width) * width);
+  if (height > 0) grid.offset.y = static_cast<int>(grid.offset.y - floor_div(grid.offset.y, height) * height);
+}
+
 auto grid_space_grid_coord_origin_x(const grid_t& grid, const int coord_x) -> int { return grid.cell_size * coord_x; }
 
 auto grid_space_grid_coord_origin_y(const grid_t& grid, const int coord_y) -> int { return grid.cell_size * coord_y; }
@@ -75,7 +154,7 @@ auto display_space_grid_coord_x(const display::display_t& display, grid_t& grid,
   int cell_width = grid.cell_size;
   int adjusted_x = x - grid.offset.x - half(window_width) + half(cell_width);
   int coord_x = adjusted_x / cell_width;
-  return adjusted_x < 0 ? --coord_x : coord_x;
+  return wrap_grid_coord_x(grid, (adjusted_x < 0 ? --coord_x : coord_x) * (1 << grid.zoom_shift));
 }
 
 auto display_space_grid_coord_y(const display::display_t& display, grid_t& grid, int y) -> int {
@@ -85,7 +164,63 @@ auto display_space_grid_coord_y(const display::display_t& display, grid_t& grid,
   int cell_height = grid.cell_size;
   int adjusted_y = y - grid.offset.y - half(window_height) + half(cell_height);
   int coord_y = adjusted_y / cell_height;
-  return adjusted_y < 0 ? --coord_y : coord_y;
+  return wrap_grid_coord_y(grid, (adjusted_y < 0 ? --coord_y : coord_y) * (1 << grid.zoom_shift));
+}
+
+auto clamp_coord(const int64_t coord) -> int { return static_cast<int>(std::clamp<int64_t>(coord, std::numeric_limits<int>::min(), std::numeric_limits<int>::max())); }
+
+// recomputes the transform when the window, cell size or offset has changed since the last call
+auto refresh_grid_viewport(const display::display_t& display, grid_t& grid) -> const grid_viewport_t& {
+  wrap_grid_offset(grid);
+
+  grid_viewport_t& viewport = grid.viewport;
+  if (!viewport.stale && viewport.cell_size == grid.cell_size && viewport.zoom_shift == grid.zoom_shift && viewport.offset.x == grid.offset.x && viewport.offset.y == grid.offset.y) return viewport;
+
+  if (viewport.stale) SDL_GetWindowSize(display.window, &viewport.window_width, &viewport.window_height);
+  viewport.stale = false;
+  viewport.cell_size = grid.cell_size;
+  viewport.zoom_shift = grid.zoom_shift;
+  viewport.offset = grid.offset;
+
+  viewport.origin_x = grid.offset.x + half(viewport.window_width);
+  viewport.origin_y = grid.offset.y + half(viewport.window_height);
+
+  // a cell spans [origin + coord * size - radius, origin + coord * size - radius + size)
+  // zoomed out, the block of cells coord >> zoom_shift lands on pixel origin + block
+  int radius = half(grid.cell_size);
+  int64_t blocks = int64_t{1} << grid.zoom_shift;
+  viewport.min_x = clamp_coord(floor_div(int64_t{radius} - viewport.origin_x, grid.cell_size) * blocks);
+  viewport.min_y = clamp_coord(floor_div(int64_t{radius} - viewport.origin_y, grid.cell_size) * blocks);
+  viewport.max_x = clamp_coord((floor_div(int64_t{viewport.window_width} + radius - viewport.origin_x - 1, grid.cell_size) + 1) * blocks - 1);
+  viewport.max_y = clamp_coord((floor_div(int64_t{viewport.window_height} + radius - viewport.origin_y - 1, grid.cell_size) + 1) * blocks - 1);
+  return viewport;
+}
+
+auto viewport_space_grid_coord_origin_x(const grid_viewport_t& viewport, const int coord_x) -> int { return coord_x * viewport.cell_size + viewport.origin_x; }
+
+auto viewport_space_grid_coord_origin_y(const grid_viewport_t& viewport, const int coord_y) -> int { return coord_y * viewport.cell_size + viewport.origin_y; }
+
+// calls function(x, y) for every coord of the line between two coords, both ends included
+template <typename function_t>
+auto for_each_grid_line_coord(int x, int y, const int end_x, const int end_y, function_t&& function) -> void {
+  int delta_x = std::abs(end_x - x);
+  int delta_y = -std::abs(end_y - y);
+  int step_x = x < end_x ? 1 : -1;
+  int step_y = y < end_y ? 1 : -1;
+  int error = delta_x + delta_y;
+  while (true) {
+    function(x, y);
+    if (x == end_x && y == end_y) return;
+    int doubled = 2 * error;
+    if (doubled >= delta_y) {
+      error += delta_y;
+      x += step_x;
+    }
+    if (doubled <= delta_x) {
+      error += delta_x;
+      y += step_y;
+    }
+  }
 }
 
 auto increment_grid_subdivisions(const display::display_t& display, grid_t& grid) -> void {
@@ -111,12 +246,25 @@ auto modify_grid_cell_wdith_height(grid_t& grid, int delta_width, int delta_heig
   grid.cell_height += delta_height;
 }
 
+// shrinking past one pixel per cell zooms out by powers of two, growing zooms back in first
 auto modify_grid_cell_size(grid_t& grid, int delta_size) -> void {
+  if (delta_size > 0 && grid.zoom_shift > 0) {
+    --grid.zoom_shift;
+    return;
+  }
+
   int new_size = grid.cell_size + delta_size;
-  if (new_size > 0) grid.cell_size = new_size;
+  if (new_size > 0)
+    grid.cell_size = new_size;
+  else if (grid.cell_size > 1)
+    grid.cell_size = 1;
+  else if (grid.zoom_shift < grid_max_zoom_shift)
+    ++grid.zoom_shift;
 }
 
 auto update_grid(SDL_Event& event, const display::display_t& display, grid_t& grid) -> void {
+  if (event.type == SDL_WINDOWEVENT) grid.viewport.stale = true;
+
   if (event.type == SDL_MOUSEMOTION) {
     grid.cursor_x = event.motion.x;
     grid.cursor_y = event.motion.y;
@@ -3,10 +3,15 @@
 // 9th of March, 2022
 //
 
-#include <map>
-
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdio>
 #include <random>
+#include <string>
+
+#include <unistd.h>
 
 #include "czmq.h"
 #include "fmt/chrono.h"
@@ -15,10 +20,35 @@
 #include "console.hpp"
 #include "console_render.hpp"
 #include "display.hpp"
+#include "display_batch.hpp"
+#include "display_canvas.hpp"
+#include "display_wake.hpp"
+
+#include "engine.hpp"
+#include "engine_index.hpp"
+#include "engine_parse.hpp"
+#include "engine_pyramid.hpp"
+#include "engine_simulation.hpp"
 
 #include "grid.hpp"
 
-using color_t = std::array<uint8_t, 3>;
+#include "pattern.hpp"
+#include "pattern_loader.hpp"
+#include "pattern_macrocell.hpp"
+#include "pattern_rle.hpp"
+#include "pattern_snapshot.hpp"
+#include "pattern_stamp.hpp"
+
+#include "profile.hpp"
+#include "profile_allocation.hpp"
+
+#include "remote.hpp"
+#include "remote_publisher.hpp"
+#include "remote_viewer.hpp"
+
+#include "shard.hpp"
+#include "shard_coordinator.hpp"
+#include "shard_worker.hpp"
 
 struct random_color_generator_t {
   std::random_device device;
@@ -27,8 +57,8 @@ struct random_color_generator_t {
 
   random_color_generator_t() : generator(device()) {}
 
-  auto generate() -> color_t {
-    color_t color;
+  auto generate() -> engine::color_t {
+    engine::color_t color;
     color[0] = distributor(generator);
     color[1] = distributor(generator);
     color[2] = distributor(generator);
@@ -36,23 +66,6 @@ struct random_color_generator_t {
   }
 };
 
-auto average_color_component(const uint8_t c1, const uint8_t c2) -> uint8_t { return static_cast<uint8_t>((static_cast<int>(c1) + static_cast<int>(c2)) / 2); }
-
-auto average_colors(const color_t& c1, const color_t& c2) -> color_t {
-  color_t color;
-  color[0] = average_color_component(c1[0], c2[0]);
-  color[1] = average_color_component(c1[1], c2[1]);
-  color[2] = average_color_component(c1[2], c2[2]);
-  return color;
-}
-
-struct cell_t {
-  std::pair<int, int> coord;
-  std::array<uint8_t, 3> color;
-
-  auto operator<=>(const cell_t&) const = default;
-};
-
 struct program_t {
   console::console_t& console;
   display::display_t& display;
@@ -60,7 +73,55 @@ struct program_t {
   grid_t grid;
 
   random_color_generator_t color_generator;
-  std::vector<cell_t> cells;
+
+  // the engine and its cells live on the simulation thread, rendering reads the latest snapshot
+  engine::simulation::simulation_t simulation;
+  const engine::simulation::snapshot_t* snapshot{&engine::simulation::latest(simulation)};
+  // edits made while handling a frame's input, queued together once it is handled
+  std::vector<engine::simulation::edit_t> edits;
+
+  // stamps placed with the key, the selected one turned to orientation
+  std::vector<pattern::stamp::stamp_t> stamps{pattern::stamp::builtin()};
+  size_t stamp{0};
+  int orientation{0};
+
+  pattern::loader::loader_t loader;
+  pattern::snapshot::writer_t snapshot_writer;
+  std::string snapshot_state;
+
+  // why the last key or file could not do what it asked, cleared by the next one that can
+  std::string notice;
+
+  // the shard layout and endpoint when the world is stepped by workers
+  std::string shards;
+
+  // set when generations are published to remote viewers, new subscribers are served this often
+  // while the simulation has nothing to publish
+  remote::publisher::publisher_t* publisher{nullptr};
+  static constexpr auto serve_period = std::chrono::milliseconds(100);
+
+  // set when this program only views a remote one, the snapshot is rebuilt from its regions
+  remote::viewer::viewer_t* viewer{nullptr};
+  engine::simulation::snapshot_t view_snapshot;
+
+  display::batch::batch_t batch;
+  engine::pyramid::pyramid_t pyramid;
+  display::canvas::canvas_t canvas;
+  size_t rendered_cells{0};
+  std::vector<uint64_t> profile_scratch;
+
+  // a capture with an end is written out once it passes, one without waits for the key
+  bool tracing{false};
+  std::chrono::steady_clock::time_point trace_end{std::chrono::steady_clock::time_point::max()};
+
+  // the loop sleeps until input, a snapshot or the next thing it owes, and draws
+  // the window at most once per refresh of the screen and only after something changed
+  display::wake::wake_t wake;
+  std::atomic<bool> awaiting_snapshot{false};
+  bool display_dirty{true};
+  bool console_dirty{true};
+  std::chrono::steady_clock::duration frame_period{std::chrono::milliseconds(16)};
+  std::chrono::steady_clock::time_point next_frame;
 
   program_t(console::console_t& console, display::display_t& display) : console(console), display(display) {
     int window_width, window_height;
@@ -68,10 +129,14 @@ struct program_t {
 
     grid.subdivisions = 3;
     grid.cell_size = window_width >> grid.subdivisions;
+
+    simulation.published = program_t::snapshot_published;
+    simulation.listener = this;
   }
 
   bool running{true};
   bool updating{false};
+  double rate{0.0};
 
   bool mouse_left_pressed{false};
   bool mouse_right_pressed{false};
@@ -79,185 +144,429 @@ struct program_t {
   bool adding_cells{false};
   bool removing_cells{false};
 
+  // the cell a drag last painted and where the mouse has moved to since
+  int paint_x{0};
+  int paint_y{0};
+  bool motion_pending{false};
+  int motion_x{0};
+  int motion_y{0};
+
   auto run() -> void {
-    zloop_t* loop = zloop_new();
+    profile::trace::name_thread("main");
+    frame_period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / display::refresh_rate(display)));
+    display::wake::watch(wake, STDIN_FILENO);
 
-    int update_id = zloop_timer(loop, 1, 0, program_t::loop_update, this);
+    SDL_Event event;
+    while (running) {
+      bool woken = SDL_WaitEventTimeout(&event, wait_ms()) != 0;
 
-    // zloop_start returns -1 when a handler cancels the loop
-    // zloop_start returns  0 when the loop is interrupted
-    bool interrupted = zloop_start(loop) == 0;
-    while (interrupted) interrupted = zloop_start(loop) == 0;
+      profile::scope_t scope(profile::timer_e::frame);
+      display::wake::clear(wake);
+      update(woken ? &event : nullptr);
+      render();
+    }
+  }
+
+  // milliseconds until something is due, -1 sleeps until woken
+  auto wait_ms() -> int {
+    using clock = std::chrono::steady_clock;
+    auto now = clock::now();
+    auto until = clock::time_point::max();
+    if (display_dirty) until = next_frame;
+    if (console_dirty) until = std::min(until, console::render::next_due(console));
+    if (tracing) until = std::min(until, trace_end);
+
+    // the loader, the snapshot writer and a publisher being viewed are polled once a frame while they have work
+    if (loader.loading || snapshot_writer.writing || viewer != nullptr) until = std::min(until, now + frame_period);
 
-    zloop_destroy(&loop);
+    // viewers joining a paused publisher are answered from here
+    if (publisher != nullptr) until = std::min(until, now + serve_period);
+
+    if (until <= now) return 0;
+
+    // any sleep is cut short by a snapshot, and one published before this was asked for would never wake the loop
+    awaiting_snapshot = true;
+    if (viewer == nullptr && engine::simulation::fresh_snapshot(simulation)) {
+      awaiting_snapshot = false;
+      return 0;
+    }
+    if (until == clock::time_point::max()) return -1;
+    return static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(until - now).count());
+  }
+
+  // the simulation's listener, wakes the loop whenever it is asleep, the wake queues one event at most
+  static auto snapshot_published(void* context) -> void {
+    auto& program = *static_cast<program_t*>(context);
+    if (program.awaiting_snapshot.exchange(false)) display::wake::signal(program.wake);
   }
 
   auto update_console() -> void {
-    chtype input = wgetch(stdscr);
-    if (input == '\n') running = false;
-    if (input == 27) running = false;
+    console::mouse::reset(console.mouse);
+
+    chtype input;
+    while ((input = wgetch(stdscr)) != static_cast<chtype>(ERR)) {
+      if (input == '\n') running = false;
+      if (input == 27) running = false;
+      if (input == KEY_MOUSE) console::mouse::update(console.mouse);
+      console_dirty = true;
+    }
+  }
 
-    if (input == KEY_MOUSE)
-      console::mouse::update(console.mouse);
-    else
-      console::mouse::reset(console.mouse);
+  auto queue_edit(const engine::simulation::edit_t& edit) -> void { edits.push_back(edit); }
+
+  // one queue, and so one indexed pass on the simulation thread, for every edit of the frame
+  auto commit_edits() -> void {
+    if (edits.empty()) return;
+    engine::simulation::queue(simulation, edits);
+    edits.clear();
   }
 
-  auto update_cells() -> void {
-    auto previous_cells = cells;
-    cells.clear();
+  auto update_cells() -> void { queue_edit({engine::simulation::edit_e::step, 0, 0, {}}); }
 
-    auto check_neighbour = [&](int x, int y) -> bool {
-      auto coord_pred = [&x, &y](const cell_t& cell) -> bool { return x == cell.coord.first && y == cell.coord.second; };
-      auto found_cell = std::ranges::find_if(previous_cells, coord_pred);
-      return found_cell != std::end(previous_cells);
-    };
+  auto set_updating(bool value) -> void {
+    updating = value;
+    engine::simulation::set_updating(simulation, updating);
+  }
 
-    std::array<std::pair<int, int>, 8> deltas{std::make_pair(0, -1), std::make_pair(1, -1), std::make_pair(1, 0),  std::make_pair(1, 1),
-                                              std::make_pair(0, 1),  std::make_pair(-1, 1), std::make_pair(-1, 0), std::make_pair(-1, -1)};
+  // halving from flat out starts at 64 generations per second, doubling past 4096 goes flat out
+  auto modify_rate(bool faster) -> void {
+    if (faster)
+      rate = rate == 0.0 || rate >= 4096.0 ? 0.0 : rate * 2.0;
+    else
+      rate = rate == 0.0 ? 64.0 : std::max(rate / 2.0, 1.0);
+    engine::simulation::set_rate(simulation, rate);
+  }
 
-    std::map<std::pair<int, int>, int> candidate_coords;
-    std::map<std::pair<int, int>, color_t> candidate_colors;
+  auto add_cell(int x, int y) -> void { queue_edit({engine::simulation::edit_e::add, x, y, color_generator.generate()}); }
 
-    for (const auto& cell : previous_cells) {
-      int neighbour_count = 0;
+  auto remove_cell(int x, int y) -> void { queue_edit({engine::simulation::edit_e::remove, x, y, {}}); }
 
-      int x = cell.coord.first;
-      int y = cell.coord.second;
-      for (const auto& [delta_x, delta_y] : deltas) {
-        int coord_x = x + delta_x;
-        int coord_y = y + delta_y;
-        if (check_neighbour(coord_x, coord_y)) {
-          ++neighbour_count;
-        } else {
-          auto candidate_coord = std::make_pair(coord_x, coord_y);
-          if (candidate_coords.contains(candidate_coord)) {
-            ++candidate_coords[candidate_coord];
-            candidate_colors[candidate_coord] = average_colors(candidate_colors[candidate_coord], cell.color);
-          } else {
-            candidate_coords.insert({candidate_coord, 1});
-            candidate_colors.insert({candidate_coord, cell.color});
-          }
-        }
-      }
+  enum struct toggle_action_e { add, remove };
 
-      // if cell has 2 neighbours, cell lives on
-      // if cell has 3 neighoburs, cell lives on
-      if (neighbour_count >= 2 && neighbour_count <= 3) cells.push_back(cell);
+  // decided against the latest snapshot, so a drag keeps adding or removing like the first click
+  auto toggle_cell(int x, int y) -> toggle_action_e {
+    if (engine::index::contains(snapshot->index, snapshot->cells, x, y)) {
+      remove_cell(x, y);
+      return toggle_action_e::remove;
+    } else {
+      add_cell(x, y);
+      return toggle_action_e::add;
     }
+  }
 
-    // and dead cell with 3 live neighbours becomes a live cell
-    for (const auto& [coord, count] : candidate_coords) {
-      // if (count == 3) cells.emplace_back(coord, color_generator.generate());
-      if (count == 3) cells.emplace_back(coord, candidate_colors[coord]);
+  // replaces the board, the cells arrive in batches while the file is parsed, and runs the
+  // rule the file was saved with unless file_rule is false
+  auto load_pattern(const std::string& path, const bool file_rule = true) -> void {
+    if (pattern::file::extension(path) == "snap") {
+      load_snapshot(path);
+      return;
     }
-  }
 
-  auto add_cell(int x, int y) -> bool {
-    auto coord_pred = [&x, &y](const cell_t& cell) -> bool { return cell.coord.first == x && cell.coord.second == y; };
-    auto found_cell = std::ranges::find_if(cells, coord_pred);
-    if (found_cell == std::end(cells)) {
-      cell_t cell{{x, y}, color_generator.generate()};
-      cells.push_back(cell);
-      return true;
+    set_updating(false);
+    queue_edit({engine::simulation::edit_e::clear, 0, 0, {}});
+    notice.clear();
+    if (std::string rule = file_rule ? pattern::loader::rule(path) : std::string(); !rule.empty()) {
+      engine::ltl::rule_t ltl_rule;
+      engine::rule::rule_t bs_rule;
+      bool ltl = engine::ltl::parse(rule, ltl_rule);
+      if (!ltl && !engine::rule::parse(rule, bs_rule)) {
+        notice = "unknown rule " + rule + " in " + path;
+      } else if (ltl && snapshot->stats.topology != engine::world::topology_e::plane) {
+        notice = "a finite world runs B/S rules only, not " + rule;
+      } else {
+        commit_edits();
+        engine::simulation::queue_rulestring(simulation, std::move(rule));
+      }
     }
-    return false;
+    pattern::loader::start(loader, path);
+  }
+
+  auto update_loader() -> void {
+    if (!pattern::loader::pending(loader)) return;
+
+    pattern::loader::drain(loader, [this](const int x, const int y) { edits.push_back({engine::simulation::edit_e::append, x, y, color_generator.generate()}); });
   }
 
-  auto remove_cell(int x, int y) -> bool {
-    auto coord_pred = [&x, &y](const cell_t& cell) -> bool { return cell.coord.first == x && cell.coord.second == y; };
-    auto erased = std::erase_if(cells, coord_pred);
-    return erased != 0;
+  auto coords() const -> pattern::coords_t {
+    pattern::coords_t coords;
+    coords.reserve(snapshot->cells.size());
+    for (const auto& cell : snapshot->cells) coords.push_back(cell.coord);
+    return coords;
   }
 
-  enum struct toggle_action_e { add, remove };
+  // the rulestring of whichever rule the engine runs
+  auto rule_name() const -> std::string {
+    const auto& stats = snapshot->stats;
+    return stats.kind == engine::kind_e::ltl ? engine::ltl::format(stats.ltl_rule) : engine::rule::format(stats.rule);
+  }
 
-  auto toggle_cell(int x, int y) -> toggle_action_e {
-    auto coord_pred = [&x, &y](const cell_t& cell) -> bool { return cell.coord.first == x && cell.coord.second == y; };
-    auto found_cell = std::ranges::find_if(cells, coord_pred);
-    if (found_cell != std::end(cells)) {
-      std::erase(cells, *found_cell);
-      return toggle_action_e::remove;
-    } else {
-      cell_t cell{{x, y}, color_generator.generate()};
-      cells.push_back(cell);
-      return toggle_action_e::add;
+  auto save_rle(const std::string& path) const -> void {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) return;
+    pattern::rle::write(file, coords(), rule_name());
+    std::fclose(file);
+  }
+
+  // the copy is taken here, encoding and writing happen on the writer's thread
+  auto save_snapshot(const std::string& path) -> void {
+    bool started = pattern::snapshot::save(snapshot_writer, path, snapshot->cells, snapshot->stats.generation, rule_name(), true);
+    snapshot_state = started ? "saving " + path : "busy";
+  }
+
+  // restores the board, generation and rule in one edit
+  auto load_snapshot(const std::string& path) -> void {
+    pattern::snapshot::view_t view;
+    if (!pattern::snapshot::open(path, view)) {
+      snapshot_state = "could not load " + path;
+      return;
     }
+
+    engine::ltl::rule_t ltl_rule;
+    if (engine::ltl::parse(pattern::snapshot::rule(view), ltl_rule) && snapshot->stats.topology != engine::world::topology_e::plane) {
+      snapshot_state = "a finite world cannot run the rule of " + path;
+      return;
+    }
+
+    engine::simulation::restore_t board;
+    board.cells.reserve(view.header->population);
+    pattern::snapshot::for_each_cell(view, [&board](const int x, const int y, const engine::color_t& color) { board.cells.push_back(engine::cell_t{{x, y}, color}); });
+    board.generation = view.header->generation;
+    board.rule = pattern::snapshot::rule(view);
+
+    set_updating(false);
+    pattern::loader::cancel(loader);
+    commit_edits();
+    engine::simulation::restore(simulation, std::move(board));
+    snapshot_state = "loaded " + path;
   }
 
-  auto toggle_rpentomino(int x, int y) -> void {
-    toggle_cell(x, y);
-    toggle_cell(x, y - 1);
-    toggle_cell(x, y + 1);
-    toggle_cell(x - 1, y);
-    toggle_cell(x + 1, y - 1);
+  auto save_macrocell(const std::string& path) const -> void {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) return;
+    engine::hashlife::hashlife_t hashlife;
+    engine::hashlife::set_rule(hashlife, snapshot->stats.rule);
+    engine::hashlife::load(hashlife, snapshot->cells);
+    pattern::macrocell::write(file, hashlife, rule_name(), snapshot->stats.generation);
+    std::fclose(file);
   }
 
-  auto update_display() -> void {
-    SDL_Event event;
-    while (SDL_PollEvent(&event)) {
-      if (event.type == SDL_QUIT) running = false;
+  // a torus loops the view around, the other worlds pan without bound
+  auto wrap_grid(const engine::world::world_t& world) -> void {
+    if (world.topology == engine::world::topology_e::torus)
+      grid.wrap = grid_wrap_t{world.width, world.height, world.origin_x, world.origin_y};
+    else
+      grid.wrap = grid_wrap_t{};
+  }
 
-      if (event.type == SDL_KEYDOWN) {
-        if (event.key.keysym.sym == SDLK_RETURN) running = false;
-        if (event.key.keysym.sym == SDLK_c) updating = true;
-        if (event.key.keysym.sym == SDLK_p) updating = false;
+  // pauses and goes back through the recorded history, a step at a time
+  auto rewind(uint64_t steps) -> void {
+    if (snapshot->stats.history_capacity == 0) {
+      notice = "rewinding needs --history megabytes";
+      console_dirty = true;
+      return;
+    }
+    notice.clear();
+    set_updating(false);
+    uint64_t generations = std::min(steps * snapshot->stats.step_size, uint64_t{INT_MAX});
+    queue_edit({engine::simulation::edit_e::rewind, static_cast<int>(generations), 0, {}});
+  }
 
-        if (event.key.keysym.sym == SDLK_n) update_cells();
+  // toggles every cell of the selected stamp in the same batch as the rest of the frame's edits
+  auto place_stamp(int x, int y) -> void {
+    pattern::stamp::for_each_cell(stamps[stamp], orientation, x, y, [this](const int coord_x, const int coord_y) { queue_edit({engine::simulation::edit_e::toggle, coord_x, coord_y, color_generator.generate()}); });
+  }
 
-        if (event.key.keysym.sym == SDLK_r) {
-          int coord_x = display_space_grid_coord_x(display, grid, grid.cursor_x);
-          int coord_y = display_space_grid_coord_y(display, grid, grid.cursor_y);
-          toggle_rpentomino(coord_x, coord_y);
-        }
-      }
+  // a drag paints every cell on the line from the last one it painted, whatever the mouse skipped
+  auto paint_to(int x, int y) -> void {
+    for_each_grid_line_coord(paint_x, paint_y, x, y, [this](const int coord_x, const int coord_y) {
+      if (coord_x == paint_x && coord_y == paint_y) return;
+      if (adding_cells)
+        add_cell(coord_x, coord_y);
+      else if (removing_cells)
+        remove_cell(coord_x, coord_y);
+    });
+    paint_x = x;
+    paint_y = y;
+  }
 
-      if (event.type == SDL_MOUSEBUTTONDOWN) {
-        if (event.button.button == SDL_BUTTON_LEFT) {
-          int coord_x = display_space_grid_coord_x(display, grid, event.button.x);
-          int coord_y = display_space_grid_coord_y(display, grid, event.button.y);
+  // the motion events of a frame are coalesced into one line to where the mouse ended up
+  auto flush_motion() -> void {
+    if (!motion_pending) return;
+    motion_pending = false;
+    paint_to(display_space_grid_coord_x(display, grid, motion_x), display_space_grid_coord_y(display, grid, motion_y));
+  }
 
-          auto action = toggle_cell(coord_x, coord_y);
-          if (action == toggle_action_e::add) adding_cells = true;
-          else if (action == toggle_action_e::remove) removing_cells = true;
+  // everything that edits the board or drives the simulation, none of which a viewer can do
+  auto update_edits(const SDL_Event& event) -> void {
+    if (event.type != SDL_MOUSEMOTION) flush_motion();
+
+    if (event.type == SDL_KEYDOWN) {
+      if (event.key.keysym.sym == SDLK_c) set_updating(true);
+      if (event.key.keysym.sym == SDLK_p) set_updating(false);
+      if (event.key.keysym.sym == SDLK_COMMA) modify_rate(false);
+      if (event.key.keysym.sym == SDLK_PERIOD) modify_rate(true);
+
+      const auto& stats = snapshot->stats;
+      if (event.key.keysym.sym == SDLK_n) update_cells();
+      if (event.key.keysym.sym == SDLK_BACKSPACE) rewind(event.key.keysym.mod & KMOD_SHIFT ? 1000 : 1);
+      if (event.key.keysym.sym == SDLK_e) queue_edit({engine::simulation::edit_e::select, static_cast<int>(engine::next_kind(stats.kind)), 0, {}});
+      if (event.key.keysym.sym == SDLK_LEFTBRACKET) queue_edit({engine::simulation::edit_e::step_exponent, stats.step_exponent - 1, 0, {}});
+      if (event.key.keysym.sym == SDLK_RIGHTBRACKET) queue_edit({engine::simulation::edit_e::step_exponent, stats.step_exponent + 1, 0, {}});
+      if (event.key.keysym.sym == SDLK_s) save_rle("life.rle");
+      if (event.key.keysym.sym == SDLK_m) save_macrocell("life.mc");
+      if (event.key.keysym.sym == SDLK_b) save_snapshot("life.snap");
+      if (event.key.keysym.sym == SDLK_l) load_snapshot("life.snap");
+      if (event.key.keysym.sym == SDLK_u) {
+        // the ltl engine only runs its own rule, the B/S ones would change nothing on screen
+        if (stats.kind == engine::kind_e::ltl) {
+          notice = "u cycles B/S rules, the ltl engine runs " + rule_name();
+        } else {
+          auto rule = engine::rule::next_common(stats.rule);
+          queue_edit({engine::simulation::edit_e::rule, rule.birth, rule.survival, {}});
+          notice.clear();
         }
+        console_dirty = true;
       }
 
-      if (event.type == SDL_MOUSEBUTTONUP) {
-        if (event.button.button == SDL_BUTTON_LEFT) {
-          adding_cells = false;
-          removing_cells = false;
-        }
+      if (event.key.keysym.sym == SDLK_r) {
+        int coord_x = display_space_grid_coord_x(display, grid, grid.cursor_x);
+        int coord_y = display_space_grid_coord_y(display, grid, grid.cursor_y);
+        place_stamp(coord_x, coord_y);
       }
+      if (event.key.keysym.sym == SDLK_g) stamp = (stamp + (event.key.keysym.mod & KMOD_SHIFT ? stamps.size() - 1 : 1)) % stamps.size();
+      if (event.key.keysym.sym == SDLK_o) orientation = pattern::stamp::rotate(orientation);
+      if (event.key.keysym.sym == SDLK_f) orientation = pattern::stamp::reflect(orientation);
+    }
 
-      if (event.type == SDL_MOUSEMOTION) {
-        if (event.motion.state & SDL_BUTTON_LMASK) {
-          int coord_x = display_space_grid_coord_x(display, grid, event.motion.x);
-          int coord_y = display_space_grid_coord_y(display, grid, event.motion.y);
+    if (event.type == SDL_DROPFILE) {
+      load_pattern(event.drop.file);
+      SDL_free(event.drop.file);
+    }
 
-          if (adding_cells)
-            add_cell(coord_x, coord_y);
-          else if (removing_cells)
-            remove_cell(coord_x, coord_y);
-        }
+    if (event.type == SDL_MOUSEBUTTONDOWN) {
+      if (event.button.button == SDL_BUTTON_LEFT) {
+        int coord_x = display_space_grid_coord_x(display, grid, event.button.x);
+        int coord_y = display_space_grid_coord_y(display, grid, event.button.y);
 
-        if (event.motion.state & SDL_BUTTON_RMASK) modify_grid_offset(grid.offset, event.motion.xrel, event.motion.yrel);
+        auto action = toggle_cell(coord_x, coord_y);
+        if (action == toggle_action_e::add) adding_cells = true;
+        else if (action == toggle_action_e::remove) removing_cells = true;
+        paint_x = coord_x;
+        paint_y = coord_y;
       }
+    }
 
-      if (event.type == SDL_MOUSEWHEEL) modify_grid_cell_size(grid, event.wheel.y);
+    if (event.type == SDL_MOUSEBUTTONUP) {
+      if (event.button.button == SDL_BUTTON_LEFT) {
+        adding_cells = false;
+        removing_cells = false;
+      }
+    }
 
-      update_grid(event, display, grid);
+    if (event.type == SDL_MOUSEMOTION && event.motion.state & SDL_BUTTON_LMASK && (adding_cells || removing_cells)) {
+      motion_pending = true;
+      motion_x = event.motion.x;
+      motion_y = event.motion.y;
     }
   }
 
-  auto update() -> void {
-    update_console();
-    update_display();
+  // the event the loop woke with first, then every other one queued
+  auto update_display(SDL_Event* woken) -> void {
+    SDL_Event event;
+    if (woken != nullptr) handle_event(*woken);
+    while (SDL_PollEvent(&event)) handle_event(event);
+    if (viewer == nullptr) flush_motion();
+  }
+
+  auto handle_event(SDL_Event& event) -> void {
+    if (event.type == wake.event) return;
+    display_dirty = true;
+    console_dirty = true;
+
+    if (event.type == SDL_QUIT) running = false;
+
+    if (event.type == SDL_KEYDOWN) {
+      if (event.key.keysym.sym == SDLK_RETURN) running = false;
+      if (event.key.keysym.sym == SDLK_t) toggle_trace();
+    }
+
+    if (viewer == nullptr) update_edits(event);
+
+    if (event.type == SDL_MOUSEMOTION && event.motion.state & SDL_BUTTON_RMASK) modify_grid_offset(grid.offset, event.motion.xrel, event.motion.yrel);
+
+    if (event.type == SDL_MOUSEWHEEL) modify_grid_cell_size(grid, event.wheel.y);
+
+    update_grid(event, display, grid);
+  }
+
+  // subscribes to the regions in view and rebuilds the snapshot whenever they change
+  auto update_viewer() -> void {
+    const grid_viewport_t& viewport = refresh_grid_viewport(display, grid);
+    remote::viewer::watch(*viewer, viewport.min_x, viewport.min_y, viewport.max_x, viewport.max_y);
+    remote::viewer::update(*viewer);
+
+    if (view_snapshot.stats.generation != viewer->generation) console_dirty = true;
+    view_snapshot.stats.generation = viewer->generation;
+    if (view_snapshot.revision == viewer->revision) return;
+    remote::viewer::cells(*viewer, view_snapshot.cells);
+    view_snapshot.revision = viewer->revision;
+    engine::index::build(view_snapshot.index, view_snapshot.cells, view_snapshot.revision);
+    display_dirty = true;
+  }
+
+  auto start_trace(const double seconds) -> void {
+    profile::trace::start();
+    tracing = true;
+    trace_end = seconds > 0.0 ? std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds)) : std::chrono::steady_clock::time_point::max();
+  }
+
+  auto stop_trace() -> void {
+    profile::trace::stop();
+    tracing = false;
+    profile::trace::write("life.trace.json");
+  }
+
+  auto toggle_trace() -> void {
+    if (tracing)
+      stop_trace();
+    else
+      start_trace(0.0);
+  }
 
-    if (updating) update_cells();
+  auto update_trace() -> void {
+    if (tracing && std::chrono::steady_clock::now() >= trace_end) stop_trace();
+  }
+
+  auto update(SDL_Event* woken) -> void {
+    if (viewer != nullptr) {
+      update_viewer();
+      snapshot = &view_snapshot;
+    } else if (engine::simulation::fresh_snapshot(simulation)) {
+      snapshot = &engine::simulation::latest(simulation);
+      display_dirty = true;
+      console_dirty = true;
+    }
+
+    {
+      profile::scope_t scope(profile::timer_e::update_console);
+      update_console();
+    }
+    {
+      profile::scope_t scope(profile::timer_e::update_display);
+      update_display(woken);
+    }
+    {
+      profile::scope_t scope(profile::timer_e::update_loader);
+      update_loader();
+    }
+    commit_edits();
+    update_trace();
+    if (publisher != nullptr) remote::publisher::serve(*publisher);
   }
 
   auto render_console() -> void {
+    profile::scope_t scope(profile::timer_e::render_console);
+
     console::render::erase(console);
     console::render::border(console);
     console::render::header(console, "", "Life", "");
@@ -265,81 +574,666 @@ struct program_t {
     console::render::line(console, "Display");
     int window_width, window_height;
     SDL_GetWindowSize(display.window, &window_width, &window_height);
-    console::render::line(console, fmt::format("display.width: {}", window_width));
-    console::render::line(console, fmt::format("display.height: {}", window_height));
+    console::render::line(console, "display.width: {}", window_width);
+    console::render::line(console, "display.height: {}", window_height);
     console::render::divider(console);
 
     console::render::line(console, "Grid");
-    console::render::line(console, fmt::format("grid.subdivisions: {}", grid.subdivisions));
-    console::render::line(console, fmt::format("grid.max_subdivisions: {}", grid_max_subdivisions(display, grid)));
-    console::render::line(console, fmt::format("grid.cell_width: {}", grid.cell_width));
-    console::render::line(console, fmt::format("grid.cell_height: {}", grid.cell_height));
-    console::render::line(console, fmt::format("grid.cell_size: {}", grid.cell_size));
-    console::render::line(console, fmt::format("grid.offset.x: {}", grid.offset.x));
-    console::render::line(console, fmt::format("grid.offset.y: {}", grid.offset.y));
-    console::render::line(console, fmt::format("grid.cursor_x: {}", grid.cursor_x));
-    console::render::line(console, fmt::format("grid.cursor_y: {}", grid.cursor_y));
+    console::render::line(console, "grid.subdivisions: {}", grid.subdivisions);
+    console::render::line(console, "grid.max_subdivisions: {}", grid_max_subdivisions(display, grid));
+    console::render::line(console, "grid.cell_width: {}", grid.cell_width);
+    console::render::line(console, "grid.cell_height: {}", grid.cell_height);
+    console::render::line(console, "grid.cell_size: {}", grid.cell_size);
+    console::render::line(console, "grid.zoom_shift: {}", grid.zoom_shift);
+    console::render::line(console, "grid.offset.x: {}", grid.offset.x);
+    console::render::line(console, "grid.offset.y: {}", grid.offset.y);
+    console::render::line(console, "grid.cursor_x: {}", grid.cursor_x);
+    console::render::line(console, "grid.cursor_y: {}", grid.cursor_y);
     console::render::divider(console);
 
     console::render::line(console, "Life");
-    console::render::line(console, fmt::format("updating: {}", updating));
-    console::render::line(console, fmt::format("mouse_left_pressed: {}", mouse_left_pressed));
-    console::render::line(console, fmt::format("mouse_right_pressed: {}", mouse_right_pressed));
-    console::render::line(console, fmt::format("cells.size: {}", cells.size()));
+    const auto& stats = snapshot->stats;
+    console::render::line(console, "updating: {}", updating);
+    if (rate > 0.0) console::render::line(console, "rate: {} / s", rate);
+    else console::render::line(console, "rate: flat out");
+    console::render::line(console, "generations_per_second: {:.1f}", stats.generations_per_second);
+    console::render::line(console, "step_time: {:.3f} ms", static_cast<double>(stats.step_ns) / 1e6);
+    console::render::line(console, "engine: {}", engine::kind_name(stats.kind));
+    console::render::line(console, "rule: {}", rule_name());
+    if (!notice.empty()) console::render::line(console, "notice: {}", notice);
+    if (stats.topology == engine::world::topology_e::plane) console::render::line(console, "world: plane");
+    else console::render::line(console, "world: {} {}x{}", engine::world::topology_name(stats.topology), stats.world_width, stats.world_height);
+    if (!shards.empty()) console::render::line(console, "shards: {}", shards);
+    console::render::line(console, "generation: {}", stats.generation);
+    console::render::line(console, "step: 2^{} = {}", stats.step_exponent, stats.step_size);
+    console::render::line(console, "threads: {}", stats.threads);
+    console::render::line(console, "steals: {}", stats.steals);
+    console::render::line(console, "mouse_left_pressed: {}", mouse_left_pressed);
+    console::render::line(console, "mouse_right_pressed: {}", mouse_right_pressed);
+    console::render::line(console, "cells.size: {}", snapshot->cells.size());
+    console::render::line(console, "cells.rendered: {}", rendered_cells);
+    console::render::line(console, "stamp: {} ({}{})", stamps[stamp].name, pattern::stamp::rotation(orientation), pattern::stamp::reflected(orientation) ? ", reflected" : "");
     console::render::divider(console);
+
+    if (!loader.path.empty()) {
+      console::render::line(console, "Pattern");
+      console::render::line(console, "pattern.path: {}", loader.path);
+      console::render::line(console, "pattern.parsed: {}", loader.parsed.load());
+      console::render::line(console, "pattern.state: {}", loader.loading ? "loading" : loader.failed ? "failed" : "loaded");
+      console::render::divider(console);
+    }
+
+    if (!snapshot_state.empty()) {
+      console::render::line(console, "Snapshot");
+      console::render::line(console, "snapshot.last: {}", snapshot_state);
+      console::render::line(console, "snapshot.writer: {}", snapshot_writer.writing ? "writing" : snapshot_writer.failed ? "failed" : "idle");
+      console::render::divider(console);
+    }
+
+    if (stats.kind == engine::kind_e::tile) {
+      console::render::line(console, "Tiles");
+      console::render::line(console, "tiles.count: {}", stats.tiles);
+      console::render::line(console, "tiles.computed: {} ({} total)", stats.tiles_computed, stats.tiles_total_computed);
+      console::render::line(console, "tiles.skipped: {} ({} total)", stats.tiles_skipped, stats.tiles_total_skipped);
+      console::render::line(console, "tiles.woken: {} ({} total)", stats.tiles_woken, stats.tiles_total_woken);
+      console::render::divider(console);
+    }
+
+    if (stats.kind == engine::kind_e::hashlife) {
+      console::render::line(console, "HashLife");
+      console::render::line(console, "hashlife.nodes: {}", stats.hashlife_nodes);
+      console::render::line(console, "hashlife.hit_rate: {:.1f}%", stats.hashlife_hit_rate * 100.0);
+      console::render::line(console, "hashlife.memory: {} / {} MB", stats.hashlife_memory >> 20, stats.hashlife_memory_limit >> 20);
+      console::render::line(console, "hashlife.collections: {}", stats.hashlife_collections);
+      console::render::divider(console);
+    }
+
+    if (publisher != nullptr) {
+      console::render::line(console, "Publisher");
+      console::render::line(console, "publisher.endpoint: {}", publisher->endpoint);
+      console::render::line(console, "publisher.messages: {}", publisher->messages);
+      console::render::line(console, "publisher.bytes: {}", publisher->bytes);
+      console::render::divider(console);
+    }
+
+    if (viewer != nullptr) {
+      console::render::line(console, "Viewer");
+      console::render::line(console, "viewer.endpoint: {}", viewer->endpoint);
+      console::render::line(console, "viewer.population: {}", viewer->population);
+      console::render::line(console, "viewer.regions: {} / {}", remote::viewer::synced_regions(*viewer), viewer->watching_all ? "all" : std::to_string(viewer->watched.size()));
+      console::render::line(console, "viewer.messages: {}", viewer->messages);
+      console::render::line(console, "viewer.bytes: {}", viewer->bytes);
+      console::render::line(console, "viewer.desyncs: {}", viewer->desyncs);
+      console::render::divider(console);
+    }
+
+    if (stats.history_capacity > 0) {
+      console::render::line(console, "History");
+      console::render::line(console, "history.memory: {:.1f} / {} MB", static_cast<double>(stats.history_memory) / (1 << 20), stats.history_capacity >> 20);
+      console::render::line(console, "history.records: {}", stats.history_records);
+      console::render::line(console, "history.oldest: {}", stats.history_oldest);
+      console::render::divider(console);
+    }
+
+    if constexpr (profile::enabled) {
+      console::render::line(console, "Profile");
+      for (int timer = 0; timer < profile::timer_count; ++timer) {
+        auto summary = profile::summarize(static_cast<profile::timer_e>(timer), profile_scratch);
+        console::render::line(console, "{}: {:.1f} / {:.1f} / {:.1f} us", profile::timer_names[timer], summary.p50 / 1e3, summary.p99 / 1e3, summary.max / 1e3);
+      }
+      for (int counter = 0; counter < profile::counter_count; ++counter) console::render::line(console, "{}: {}", profile::counter_names[counter], profile::total(static_cast<profile::counter_e>(counter)));
+      console::render::line(console, "heap_allocations: {}", profile::allocation::allocations());
+      console::render::divider(console);
+    }
+
+    console::render::finish(console);
   }
 
   auto render_cells() -> void {
-    int radius = half(grid.cell_size);
-    for (const auto& cell : cells) {
-      int display_x = display_space_grid_coord_origin_x(display, grid, cell.coord.first);
-      int display_y = display_space_grid_coord_origin_y(display, grid, cell.coord.second);
+    const grid_viewport_t& viewport = refresh_grid_viewport(display, grid);
+    const auto& cells = snapshot->cells;
+
+    int radius = half(viewport.cell_size);
+    rendered_cells = 0;
+
+    // a torus is drawn once for every period the window reaches into
+    const grid_wrap_t& wrap = grid.wrap;
+    auto [begin_x, end_x] = grid_wrap_copies(viewport.min_x, viewport.max_x, wrap.width, wrap.origin_x);
+    auto [begin_y, end_y] = grid_wrap_copies(viewport.min_y, viewport.max_y, wrap.height, wrap.origin_y);
+    for (int copy_y = begin_y; copy_y <= end_y; ++copy_y) {
+      for (int copy_x = begin_x; copy_x <= end_x; ++copy_x) {
+        int shift_x = copy_x * wrap.width;
+        int shift_y = copy_y * wrap.height;
+        engine::index::query(snapshot->index, cells, viewport.min_x - shift_x, viewport.min_y - shift_y, viewport.max_x - shift_x, viewport.max_y - shift_y, [&](const engine::cell_t& cell) {
+          int display_x = viewport_space_grid_coord_origin_x(viewport, cell.coord.first + shift_x);
+          int display_y = viewport_space_grid_coord_origin_y(viewport, cell.coord.second + shift_y);
+
+          SDL_Rect rect;
+          rect.x = display_x - radius;
+          rect.y = display_y - radius;
+          rect.w = viewport.cell_size;
+          rect.h = viewport.cell_size;
+
+          display::batch::add(batch, cell.color[0], cell.color[1], cell.color[2], rect);
+          ++rendered_cells;
+        });
+      }
+    }
+    display::batch::submit(batch, display.renderer);
+  }
 
-      SDL_Rect rect;
-      rect.x = display_x - radius;
-      rect.y = display_y - radius;
-      rect.w = grid.cell_size;
-      rect.h = grid.cell_size;
+  // one pixel per 2^zoom_shift block, looked up per pixel when the window holds fewer pixels than the level has blocks
+  auto render_pyramid() -> void {
+    const grid_viewport_t& viewport = refresh_grid_viewport(display, grid);
+    display::canvas::resize(canvas, display.renderer, viewport.window_width, viewport.window_height);
+    display::canvas::clear(canvas);
+
+    // a wrapped axis shows the whole of its period however far the window reaches
+    const grid_wrap_t& wrap = grid.wrap;
+    int min_x = wrap.width > 0 ? wrap.origin_x : viewport.min_x;
+    int max_x = wrap.width > 0 ? wrap.origin_x + wrap.width - 1 : viewport.max_x;
+    int min_y = wrap.height > 0 ? wrap.origin_y : viewport.min_y;
+    int max_y = wrap.height > 0 ? wrap.origin_y + wrap.height - 1 : viewport.max_y;
+    auto& level = engine::pyramid::level(pyramid, snapshot->index, snapshot->cells, snapshot->revision, viewport.zoom_shift, min_x, min_y, max_x, max_y);
+    double area = static_cast<double>(uint64_t{1} << (2 * viewport.zoom_shift));
+
+    rendered_cells = 0;
+    auto plot_at = [&](const engine::pyramid::block_t& block, const int64_t x, const int64_t y) {
+      if (x < 0 || x >= canvas.width || y < 0 || y >= canvas.height) return;
+
+      // the mean colour, dimmed by how sparse the block is but never to black
+      double brightness = 0.25 + 0.75 * static_cast<double>(block.count) / area;
+      auto channel = [&](const int index) { return static_cast<uint8_t>(static_cast<double>(block.color_sum[index]) / static_cast<double>(block.count) * brightness); };
+      display::canvas::set(canvas, static_cast<int>(x), static_cast<int>(y), display::canvas::pixel(channel(0), channel(1), channel(2)));
+      rendered_cells += block.count;
+    };
 
-      SDL_SetRenderDrawColor(display.renderer, cell.color[0], cell.color[1], cell.color[2], SDL_ALPHA_OPAQUE);
-      // SDL_RenderDrawLine(display.renderer, rect.x, rect.y, rect.x + rect.w, rect.y + rect.h);
-      // SDL_RenderDrawLine(display.renderer, rect.x, rect.y + rect.h, rect.x + rect.w, rect.y);
-      // SDL_RenderDrawRect(display.renderer, &rect);
-      SDL_RenderFillRect(display.renderer, &rect);
+    // a torus whose period is a whole number of pixels repeats across the canvas, the others are drawn once
+    int64_t period_x = grid_wrap_pixels(grid, grid.wrap.width);
+    int64_t period_y = grid_wrap_pixels(grid, grid.wrap.height);
+    int64_t step_x = period_x > 0 ? period_x : int64_t{1} << 40;
+    int64_t step_y = period_y > 0 ? period_y : int64_t{1} << 40;
+    auto plot = [&](const engine::pyramid::block_t& block) {
+      int64_t x = int64_t{block.x} + viewport.origin_x;
+      int64_t y = int64_t{block.y} + viewport.origin_y;
+      if (period_x > 0) x -= floor_div(x, period_x) * period_x;
+      if (period_y > 0) y -= floor_div(y, period_y) * period_y;
+      for (int64_t copy_y = y; copy_y < canvas.height; copy_y += step_y)
+        for (int64_t copy_x = x; copy_x < canvas.width; copy_x += step_x) plot_at(block, copy_x, copy_y);
+    };
+
+    if (canvas.pixels.size() < level.blocks.size()) {
+      int block_origin_x = grid.wrap.origin_x >> viewport.zoom_shift;
+      int block_origin_y = grid.wrap.origin_y >> viewport.zoom_shift;
+      for (int y = 0; y < canvas.height; ++y) {
+        int block_y = wrap_grid_coord(y - viewport.origin_y, static_cast<int>(period_y), block_origin_y);
+        for (int x = 0; x < canvas.width; ++x) {
+          int block_x = wrap_grid_coord(x - viewport.origin_x, static_cast<int>(period_x), block_origin_x);
+          if (const auto* block = engine::pyramid::find(level, block_x, block_y)) plot_at(*block, x, y);
+        }
+      }
+    } else {
+      for (const auto& block : level.blocks) plot(block);
     }
+
+    display::canvas::present(canvas, display.renderer);
   }
 
   auto render_display() -> void {
+    profile::scope_t scope(profile::timer_e::render_display);
+
     SDL_SetRenderDrawColor(display.renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
     SDL_RenderClear(display.renderer);
 
     // render_grid(display, grid);
 
     // render_selected_coords();
-    render_cells();
+    if (grid.zoom_shift > 0)
+      render_pyramid();
+    else
+      render_cells();
 
     SDL_RenderPresent(display.renderer);
   }
 
+  // each at its own rate, and neither when nothing has changed
   auto render() -> void {
-    render_console();
-    render_display();
-  }
+    if (console_dirty && console::render::due(console)) {
+      render_console();
+      console_dirty = false;
+    }
 
-  static auto loop_update(zloop_t* loop, int timer_id, void* arg) -> int {
-    auto& program = *reinterpret_cast<program_t*>(arg);
-    program.update();
-    program.render();
-    return program.running ? 0 : -1;
+    auto now = std::chrono::steady_clock::now();
+    if (display_dirty && now >= next_frame) {
+      render_display();
+      display_dirty = false;
+      next_frame = now + frame_period;
+    }
   }
 };
 
-auto main(int argc, char** argv) -> int {
-  console::console_t console;
-  display::display_t display("Life");
-  SDL_SetWindowSize(display.window, 640, 480);
+struct options_t {
+  engine::kind_e engine{engine::kind_e::sparse};
+  size_t hashlife_memory{512};
+  size_t threads{std::thread::hardware_concurrency()};
+  int step_exponent{0};
+  bool colorless{false};
+  engine::rule::rule_t rule{engine::rule::conway};
+  engine::ltl::rule_t ltl_rule{engine::ltl::bosco};
+
+  // a rule given here wins over the one a pattern file was saved with
+  bool rule_given{false};
+
+  // a finite world replaces the unbounded plane
+  engine::world::topology_e world{engine::world::topology_e::plane};
+  int world_width{256};
+  int world_height{256};
+
+  bool headless{false};
+
+  // a headless run stops at whichever limit it reaches first, --seconds alone lifts the generation limit
+  uint64_t generations{1000};
+  double seconds{0.0};
+
+  // generations to warm up before any heap allocation by the engine fails a headless run, zero never checks
+  uint64_t assert_steady{0};
+
+  std::string pattern;
+
+  // written when a headless run ends, load it back with --pattern to carry on
+  std::string snapshot;
+
+  int soup_width{0};
+  int soup_height{0};
+  double soup_density{0.5};
+  uint32_t seed{1};
+
+  // generations per second while running interactively, zero runs flat out
+  double rate{0.0};
+
+  // console panel frames per second, independent of the simulation rate
+  double console_rate{10.0};
+
+  // seconds of frame trace to capture from launch, zero captures only on the key
+  double trace_seconds{0.0};
+
+  // megabytes of generation history kept for rewinding, zero keeps none and is the default as
+  // recording diffs the whole board every step
+  size_t history_memory{0};
+
+  // columns x rows of workers stepping a finite world, zero steps it in this process
+  int shard_columns{0};
+  int shard_rows{0};
+
+  // ipc:// runs the workers as processes, inproc:// as threads, empty picks an ipc path
+  std::string shard_endpoint;
+
+  // set in the processes the coordinator starts
+  std::string shard_worker;
+  int shard_index{0};
+
+  // binds a publisher of every generation, tcp://*:5556 for viewers elsewhere
+  std::string publish;
+
+  // views the publisher at this endpoint instead of simulating
+  std::string view;
+
+  // pattern files added to the stamps, the first of them selected
+  std::vector<std::string> stamps;
+};
+
+auto parse_options(int argc, char** argv, options_t& options) -> bool {
+  bool generations_given = false;
+  bool engine_given = false;
+  bool ltl_rule_given = false;
+  bool bs_rule_given = false;
+  for (int arg = 1; arg < argc; ++arg) {
+    std::string_view option = argv[arg];
+    bool has_value = arg + 1 < argc;
+
+    if (option == "--engine" && has_value) {
+      if (!engine::parse_kind(argv[++arg], options.engine)) return false;
+      engine_given = true;
+    } else if (option == "--hashlife-memory" && has_value) {
+      if (!engine::parse_number(argv[++arg], options.hashlife_memory)) return false;
+    } else if (option == "--threads" && has_value) {
+      if (!engine::parse_number(argv[++arg], options.threads)) return false;
+    } else if (option == "--step-exponent" && has_value) {
+      if (!engine::parse_number(argv[++arg], options.step_exponent)) return false;
+    } else if (option == "--colorless") {
+      options.colorless = true;
+    } else if (option == "--rule" && has_value) {
+      std::string_view text = argv[++arg];
+      options.rule_given = true;
+      if (engine::ltl::parse(text, options.ltl_rule))
+        ltl_rule_given = true;
+      else if (engine::rule::parse(text, options.rule))
+        bs_rule_given = true;
+      else
+        return false;
+    } else if (option == "--world" && has_value) {
+      if (!engine::world::parse_topology(argv[++arg], options.world)) return false;
+    } else if (option == "--world-size" && has_value) {
+      if (!engine::parse_size(argv[++arg], options.world_width, options.world_height)) return false;
+    } else if (option == "--headless") {
+      options.headless = true;
+    } else if (option == "--generations" && has_value) {
+      if (!engine::parse_number(argv[++arg], options.generations)) return false;
+      generations_given = true;
+    } else if (option == "--seconds" && has_value) {
+      if (!engine::parse_number(argv[++arg], options.seconds)) return false;
+    } else if (option == "--assert-steady" && has_value) {
+      if (!engine::parse_number(argv[++arg], options.assert_steady)) return false;
+    } else if (option == "--pattern" && has_value) {
+      options.pattern = argv[++arg];
+    } else if (option == "--snapshot" && has_value) {
+      options.snapshot = argv[++arg];
+    } else if (option == "--soup" && has_value) {
+      if (!engine::parse_size(argv[++arg], options.soup_width, options.soup_height)) return false;
+    } else if (option == "--density" && has_value) {
+      if (!engine::parse_number(argv[++arg], options.soup_density)) return false;
+    } else if (option == "--rate" && has_value) {
+      if (!engine::parse_number(argv[++arg], options.rate)) return false;
+    } else if (option == "--console-rate" && has_value) {
+      if (!engine::parse_number(argv[++arg], options.console_rate)) return false;
+    } else if (option == "--history" && has_value) {
+      if (!engine::parse_number(argv[++arg], options.history_memory)) return false;
+    } else if (option == "--shards" && has_value) {
+      if (!engine::parse_size(argv[++arg], options.shard_columns, options.shard_rows)) return false;
+    } else if (option == "--shard-endpoint" && has_value) {
+      options.shard_endpoint = argv[++arg];
+    } else if (option == "--shard-worker" && has_value) {
+      options.shard_worker = argv[++arg];
+    } else if (option == "--shard-index" && has_value) {
+      if (!engine::parse_number(argv[++arg], options.shard_index)) return false;
+    } else if (option == "--publish" && has_value) {
+      options.publish = argv[++arg];
+    } else if (option == "--view" && has_value) {
+      options.view = argv[++arg];
+    } else if (option == "--stamp" && has_value) {
+      options.stamps.emplace_back(argv[++arg]);
+    } else if (option == "--trace" && has_value) {
+      if (!engine::parse_number(argv[++arg], options.trace_seconds)) return false;
+    } else if (option == "--seed" && has_value) {
+      if (!engine::parse_number(argv[++arg], options.seed)) return false;
+    } else {
+      return false;
+    }
+  }
+
+  if (options.seconds > 0.0 && !generations_given) options.generations = UINT64_MAX;
+
+  // larger than life rulestrings select the ltl engine, which runs nothing else, and no other
+  // engine or a finite world can run them
+  if (ltl_rule_given && engine_given && options.engine != engine::kind_e::ltl) {
+    fmt::print(stderr, "the {} engine cannot run larger than life rules\n", engine::kind_name(options.engine));
+    return false;
+  }
+  if (ltl_rule_given) options.engine = engine::kind_e::ltl;
+  if (bs_rule_given && options.engine == engine::kind_e::ltl) {
+    fmt::print(stderr, "the ltl engine cannot run B/S rules\n");
+    return false;
+  }
+  if (options.engine == engine::kind_e::ltl && options.world != engine::world::topology_e::plane) {
+    fmt::print(stderr, "a {} world runs B/S rules only, not the ltl engine\n", engine::world::topology_name(options.world));
+    return false;
+  }
+
+  // shards split a finite world, the unbounded plane has no edges to cut along
+  if (options.shard_columns == 0) return true;
+  if (options.world == engine::world::topology_e::plane) return false;
+  if (!shard::valid(shard::layout_t{options.world, options.world_width, options.world_height, options.shard_columns, options.shard_rows})) {
+    fmt::print(stderr, "{}x{} shards do not fit a {}x{} world\n", options.shard_columns, options.shard_rows, options.world_width, options.world_height);
+    return false;
+  }
+  return true;
+}
+
+auto print_usage(const char* program) -> void {
+  fmt::print(stderr, "usage: {} [options]\n", program);
+  fmt::print(stderr, "  --engine sparse|tile|hashlife|ltl  --hashlife-memory megabytes  --threads count  --step-exponent k  --rate generations_per_second  --colorless\n");
+  fmt::print(stderr, "  --rule B3/S23|R5,C0,M1,S34..58,B34..45,NM  --world plane|torus|bounded  --world-size widthxheight\n");
+  fmt::print(stderr, "  --shards columnsxrows  --shard-endpoint ipc://path|inproc://name  (needs a torus or bounded world, --step-exponent k gathers every 2^k generations)\n");
+  fmt::print(stderr, "  --publish tcp://*:5556  --view tcp://host:5556\n");
+  fmt::print(stderr, "  --console-rate frames_per_second  --trace seconds  --history megabytes\n");
+  fmt::print(stderr, "  --headless  --generations count  --seconds limit  --assert-steady warmup_generations  --snapshot file.snap\n");
+  fmt::print(stderr, "  --pattern file.cells|file.rle|file.mc|file.snap  --soup widthxheight  --density fraction  --seed number  --stamp file.rle\n");
+}
+
+auto configure_engine(engine::engine_t& engine, const options_t& options) -> void {
+  engine.kind = options.engine;
+  engine.hashlife.memory_limit = options.hashlife_memory << 20;
+  engine::set_step_exponent(engine, options.step_exponent);
+  engine::set_colorless(engine, options.colorless);
+  engine::set_world(engine, options.world, options.world_width, options.world_height);
+  engine::set_rule(engine, options.rule);
+  engine::set_ltl_rule(engine, options.ltl_rule);
+  engine::set_threads(engine, options.threads);
+}
+
+auto shard_endpoint(const options_t& options) -> std::string { return options.shard_endpoint.empty() ? fmt::format("ipc:///tmp/life-{}", getpid()) : options.shard_endpoint; }
 
-  program_t program(console, display);
-  program.run();
+// the world is cut into shards stepped by worker threads or processes, the engine only gathers their cells
+auto start_shards(shard::coordinator::coordinator_t& coordinator, const options_t& options) -> bool {
+  if (options.shard_columns == 0) return true;
+
+  shard::layout_t layout{options.world, options.world_width, options.world_height, options.shard_columns, options.shard_rows};
+  size_t threads = std::max<size_t>(options.threads / shard::count(layout), 1);
+  if (shard::coordinator::start(coordinator, shard_endpoint(options), layout, threads)) return true;
+  fmt::print(stderr, "could not start {} shards on {}\n", shard::count(layout), shard_endpoint(options));
+  return false;
+}
+
+auto attach_shards(shard::coordinator::coordinator_t& coordinator, const options_t& options, engine::engine_t& engine) -> void {
+  if (options.shard_columns > 0) shard::coordinator::attach(coordinator, engine);
+}
+
+auto start_publisher(remote::publisher::publisher_t& publisher, const options_t& options) -> bool {
+  if (options.publish.empty() || remote::publisher::start(publisher, options.publish)) return true;
+  fmt::print(stderr, "could not publish on {}\n", options.publish);
+  return false;
+}
+
+// appends the stamp files to the built in ones and selects the first of them
+auto load_stamps(const options_t& options, std::vector<pattern::stamp::stamp_t>& stamps, size_t& selected) -> bool {
+  if (!options.stamps.empty()) selected = stamps.size();
+  for (const auto& path : options.stamps) {
+    pattern::stamp::stamp_t stamp;
+    if (!pattern::stamp::load(path, stamp)) {
+      fmt::print(stderr, "could not load stamp {}\n", path);
+      return false;
+    }
+    stamps.push_back(std::move(stamp));
+  }
+  return true;
+}
+
+// the pattern file, else a soup, else an r-pentomino at the origin
+auto seed_coords(const options_t& options, pattern::coords_t& coords) -> bool {
+  if (pattern::file::extension(options.pattern) == "snap") return true;
+  if (!options.pattern.empty()) return pattern::loader::load(options.pattern, coords);
+
+  if (options.soup_width > 0 && options.soup_height > 0)
+    coords = pattern::soup(options.soup_width, options.soup_height, options.soup_density, options.seed);
+  else
+    coords = pattern::rpentomino(0, 0);
+  return true;
+}
+
+// an rle or macrocell pattern runs the rule it was saved with, unless --rule chose one
+auto apply_pattern_rule(const options_t& options, engine::engine_t& engine) -> bool {
+  if (options.rule_given || options.pattern.empty()) return true;
+  std::string rule = pattern::loader::rule(options.pattern);
+  return rule.empty() || engine::set_rulestring(engine, rule);
+}
+
+// a snapshot carries its own colours, generation and rule
+auto restore_snapshot(const std::string& path, engine::engine_t& engine, std::vector<engine::cell_t>& cells) -> bool {
+  pattern::snapshot::view_t view;
+  if (!pattern::snapshot::open(path, view)) return false;
+
+  cells.clear();
+  cells.reserve(view.header->population);
+  pattern::snapshot::for_each_cell(view, [&cells](const int x, const int y, const engine::color_t& color) { cells.push_back(engine::cell_t{{x, y}, color}); });
+  engine.generation = view.header->generation;
+  return engine::set_rulestring(engine, pattern::snapshot::rule(view));
+}
+
+// runs generations without touching SDL or ncurses, printing one json object per line
+auto run_headless(const options_t& options) -> int {
+  pattern::coords_t coords;
+  if (!seed_coords(options, coords)) {
+    fmt::print(stderr, "could not load pattern {}\n", options.pattern);
+    return 1;
+  }
+
+  engine::engine_t engine;
+  configure_engine(engine, options);
+  if (!apply_pattern_rule(options, engine)) {
+    fmt::print(stderr, "cannot run the rule {} of {}\n", pattern::loader::rule(options.pattern), options.pattern);
+    return 1;
+  }
+
+  shard::coordinator::coordinator_t coordinator;
+  if (!start_shards(coordinator, options)) return 1;
+  attach_shards(coordinator, options, engine);
+
+  remote::publisher::publisher_t publisher;
+  if (!start_publisher(publisher, options)) return 1;
+  bool publishing = !options.publish.empty();
+
+  std::vector<engine::cell_t> cells;
+  if (pattern::file::extension(options.pattern) == "snap") {
+    if (!restore_snapshot(options.pattern, engine, cells)) {
+      fmt::print(stderr, "could not load snapshot {}\n", options.pattern);
+      return 1;
+    }
+  } else {
+    std::mt19937 color_generator(options.seed);
+    cells.reserve(coords.size());
+    for (const auto& coord : coords) cells.push_back(engine::cell_t{coord, {static_cast<uint8_t>(color_generator()), static_cast<uint8_t>(color_generator()), static_cast<uint8_t>(color_generator())}});
+  }
+
+  using clock = std::chrono::steady_clock;
+  auto begin = clock::now();
+  auto limit = std::chrono::duration<double>(options.seconds);
+  auto trace_limit = std::chrono::duration<double>(options.trace_seconds);
+
+  profile::trace::name_thread("main");
+  if (options.trace_seconds > 0.0) profile::trace::start();
+
+  fmt::print("{{\"engine\": \"{}\", \"threads\": {}, \"shards\": {}, \"population\": {}}}\n", engine::kind_name(engine.kind), engine::pool::threads(engine.pool), options.shard_columns * options.shard_rows, cells.size());
+
+  if (publishing) remote::publisher::publish(publisher, cells, engine.generation, !engine.colorless);
+
+  uint64_t steady_allocations = 0;
+  while (engine.generation < options.generations) {
+    profile::allocation::watch_t watch;
+    auto step_begin = clock::now();
+    engine::step(engine, cells);
+    auto step_end = clock::now();
+    if (options.assert_steady > 0 && engine.generation > options.assert_steady) steady_allocations += watch.allocated();
+    if (publishing) remote::publisher::publish(publisher, cells, engine.generation, !engine.colorless);
+
+    auto step_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(step_end - step_begin).count();
+    fmt::print("{{\"generation\": {}, \"population\": {}, \"step_ns\": {}}}\n", engine.generation, cells.size(), step_ns);
+
+    if (profile::trace::capturing() && step_end - begin >= trace_limit) profile::trace::stop();
+    if (options.seconds > 0.0 && step_end - begin >= limit) break;
+  }
+
+  if (coordinator.failed) {
+    fmt::print(stderr, "a shard stopped answering at generation {}\n", coordinator.generation);
+    return 1;
+  }
+
+  if (options.trace_seconds > 0.0) {
+    profile::trace::stop();
+    profile::trace::write("life.trace.json");
+  }
+
+  if (!options.snapshot.empty()) {
+    pattern::snapshot::writer_t writer;
+    std::string rule = engine.kind == engine::kind_e::ltl ? engine::ltl::format(engine.ltl.rule) : engine::rule::format(engine.rule);
+    pattern::snapshot::save(writer, options.snapshot, cells, engine.generation, rule, !engine.colorless);
+    writer.thread.join();
+    if (writer.failed) fmt::print(stderr, "could not write snapshot {}\n", options.snapshot);
+  }
+
+  double seconds = std::chrono::duration<double>(clock::now() - begin).count();
+  double generations_per_second = seconds > 0.0 ? static_cast<double>(engine.generation) / seconds : 0.0;
+  fmt::print("{{\"generations\": {}, \"population\": {}, \"seconds\": {:.6f}, \"generations_per_second\": {:.1f}}}\n", engine.generation, cells.size(), seconds, generations_per_second);
+  profile::dump(stderr);
+
+  if (steady_allocations > 0) {
+    fmt::print(stderr, "{} heap allocations after {} warm up generations\n", steady_allocations, options.assert_steady);
+    return 1;
+  }
   return 0;
 }
+
+auto main(int argc, char** argv) -> int {
+  options_t options;
+  if (!parse_options(argc, argv, options)) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  if (!options.shard_worker.empty()) return shard::worker::run(options.shard_worker, options.shard_index, options.threads);
+  if (options.headless) return run_headless(options);
+
+  // outlives the program so the simulation thread has stopped stepping through it first
+  shard::coordinator::coordinator_t coordinator;
+  if (!start_shards(coordinator, options)) return 1;
+
+  remote::publisher::publisher_t publisher;
+  if (!start_publisher(publisher, options)) return 1;
+
+  remote::viewer::viewer_t viewer;
+  if (!options.view.empty() && !remote::viewer::connect(viewer, options.view)) {
+    fmt::print(stderr, "could not view {}\n", options.view);
+    return 1;
+  }
+
+  std::vector<pattern::stamp::stamp_t> stamps = pattern::stamp::builtin();
+  size_t stamp = 0;
+  if (!load_stamps(options, stamps, stamp)) return 1;
+
+  {
+
+    console::console_t console;
+    console.refresh_rate = options.console_rate;
+    display::display_t display("Life");
+    SDL_SetWindowSize(display.window, 640, 480);
+
+    program_t program(console, display);
+    program.stamps = std::move(stamps);
+    program.stamp = stamp;
+    configure_engine(program.simulation.engine, options);
+    program.wrap_grid(program.simulation.engine.world);
+    engine::history::set_capacity(program.simulation.history, options.history_memory << 20);
+    attach_shards(coordinator, options, program.simulation.engine);
+    if (options.shard_columns > 0) program.shards = fmt::format("{}x{} over {}", options.shard_columns, options.shard_rows, coordinator.base);
+    engine::simulation::set_rate(program.simulation, options.rate);
+    program.rate = options.rate;
+    if (options.trace_seconds > 0.0) program.start_trace(options.trace_seconds);
+    if (!options.publish.empty()) {
+      program.publisher = &publisher;
+      program.simulation.observe = remote::publisher::observe;
+      program.simulation.observer = &publisher;
+    }
+
+    // a viewer never starts the simulation, everything it shows comes from the publisher
+    if (!options.view.empty()) {
+      program.viewer = &viewer;
+    } else {
+      engine::simulation::start(program.simulation);
+      if (!options.pattern.empty()) program.load_pattern(options.pattern, !options.rule_given);
+    }
+    program.run();
+  }
+
+  // the console is closed by now so the dump lands on the terminal
+  profile::dump(stderr);
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Pattern Library
+
+#pragma once
+
+#include <atomic>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace pattern {
+
+using coords_t = std::vector<std::pair<int, int>>;
+
+auto translate(coords_t coords, const int x, const int y) -> coords_t {
+  for (auto& coord : coords) {
+    coord.first += x;
+    coord.second += y;
+  }
+  return coords;
+}
+
+// Plaintext Functions --------------------------
+// rows of 'O' or '*' for live cells, lines starting with '!' are comments
+// a set cancelled stops it at the next line with the cells read so far
+auto parse_plaintext(std::string_view text, const std::atomic<bool>* cancelled = nullptr) -> coords_t {
+  coords_t coords;
+  int y = 0;
+  while (!text.empty()) {
+    if (cancelled != nullptr && cancelled->load(std::memory_order_relaxed)) break;
+    size_t end = text.find('\n');
+    std::string_view line = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+
+    if (line.starts_with('!')) continue;
+    for (int x = 0; x < static_cast<int>(line.size()); ++x) {
+      if (line[x] == 'O' || line[x] == '*') coords.emplace_back(x, y);
+    }
+    ++y;
+  }
+  return coords;
+}
+
+auto load_plaintext(const std::string& path, coords_t& coords) -> bool {
+  std::ifstream file(path);
+  if (!file) return false;
+
+  std::stringstream text;
+  text << file.rdbuf();
+  coords = parse_plaintext(text.str());
+  return true;
+}
+// ----------------------------------------------
+
+// Canonical Patterns ---------------------------
+auto rpentomino(const int x, const int y) -> coords_t { return coords_t{{x, y}, {x, y - 1}, {x, y + 1}, {x - 1, y}, {x + 1, y - 1}}; }
+
+auto acorn() -> coords_t {
+  return parse_plaintext(".O.....\n"
+                         "...O...\n"
+                         "OO..OOO\n");
+}
+
+auto gosper_glider_gun() -> coords_t {
+  return parse_plaintext("........................O...........\n"
+                         "......................O.O...........\n"
+                         "............OO......OO............OO\n"
+                         "...........O...O....OO............OO\n"
+                         "OO........O.....O...OO..............\n"
+                         "OO........O...O.OO....O.O...........\n"
+                         "..........O.....O.......O...........\n"
+                         "...........O...O....................\n"
+                         "............OO......................\n");
+}
+
+// the single row pattern whose switch engines grow without bound
+auto one_line_growth() -> coords_t { return parse_plaintext("OOOOOOOO.OOOOO...OOO......OOOOOOO.OOOOO\n"); }
+
+// Tim Coe's Max, the smallest known spacefiller, its population grows with the square of the generation
+auto max_spacefiller() -> coords_t {
+  return parse_plaintext("..................O........\n"
+                         ".................OOO.......\n"
+                         "............OOO....OO......\n"
+                         "...........O..OOO..O.OO....\n"
+                         "..........O...O.O..O.O.....\n"
+                         "..........O....O.O.O.O.OO..\n"
+                         "............O....O.O...OO..\n"
+                         "OOOO.....O.O....O...O.OOO..\n"
+                         "O...OO.O.OOO.OO.........OO.\n"
+                         "O.....OO.....O.............\n"
+                         ".O..OO.O..O..O.OO..........\n"
+                         ".......O.O.O.O.O.O.....OOOO\n"
+                         ".O..OO.O..O..O..OO.O.OO...O\n"
+                         "O.....OO...O.O.O...OO.....O\n"
+                         "O...OO.O.OO..O..O..O.OO..O.\n"
+                         "OOOO.....O.O.O.O.O.O.......\n"
+                         "..........OO.O..O..O.OO..O.\n"
+                         ".............O.....OO.....O\n"
+                         ".OO.........OO.OOO.O.OO...O\n"
+                         "..OOO.O...O....O.O.....OOOO\n"
+                         "..OO...O.O....O............\n"
+                         "..OO.O.O.O.O....O..........\n"
+                         ".....O.O..O.O...O..........\n"
+                         "....OO.O..OOO..O...........\n"
+                         "......OO....OOO............\n"
+                         ".......OOO.................\n"
+                         "........O..................\n");
+}
+
+// density in [0, 1] over a width by height rectangle centred on the origin
+auto soup(const int width, const int height, const double density, const uint32_t seed) -> coords_t {
+  std::mt19937 generator(seed);
+  std::bernoulli_distribution alive(density);
+
+  coords_t coords;
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      if (alive(generator)) coords.emplace_back(x - width / 2, y - height / 2);
+    }
+  }
+  return coords;
+}
+// ----------------------------------------------
+
+}  // namespace pattern
@@ -0,0 +1,59 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Pattern File Functions
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace pattern::file {
+
+// a read only mapping of a whole file, the pages are faulted in as the parsers walk them
+struct mapped_file_t {
+  int descriptor{-1};
+  void* data{nullptr};
+  size_t size{0};
+
+  mapped_file_t() = default;
+  mapped_file_t(const mapped_file_t&) = delete;
+  auto operator=(const mapped_file_t&) -> mapped_file_t& = delete;
+
+  ~mapped_file_t() {
+    if (data != nullptr) munmap(data, size);
+    if (descriptor >= 0) close(descriptor);
+  }
+};
+
+auto map(const std::string& path, mapped_file_t& file) -> bool {
+  file.descriptor = open(path.c_str(), O_RDONLY);
+  if (file.descriptor < 0) return false;
+
+  struct stat status;
+  if (fstat(file.descriptor, &status) != 0) return false;
+  file.size = static_cast<size_t>(status.st_size);
+  if (file.size == 0) return true;
+
+  void* data = mmap(nullptr, file.size, PROT_READ, MAP_PRIVATE, file.descriptor, 0);
+  if (data == MAP_FAILED) return false;
+  file.data = data;
+
+  madvise(file.data, file.size, MADV_SEQUENTIAL);
+  return true;
+}
+
+auto text(const mapped_file_t& file) -> std::string_view { return file.data != nullptr ? std::string_view(static_cast<const char*>(file.data), file.size) : std::string_view(); }
+
+auto extension(std::string_view path) -> std::string_view {
+  size_t dot = path.rfind('.');
+  return dot == std::string_view::npos ? std::string_view() : path.substr(dot + 1);
+}
+
+}  // namespace pattern::file
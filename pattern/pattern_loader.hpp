@@ -0,0 +1,145 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Pattern Loader Functions
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pattern.hpp"
+#include "pattern_file.hpp"
+#include "pattern_macrocell.hpp"
+#include "pattern_rle.hpp"
+
+namespace pattern::loader {
+
+// picks the reader from the extension, .rle and .mc, anything else is plaintext
+template <typename function_t>
+auto parse(const std::string& path, function_t&& function, const std::atomic<bool>* cancelled = nullptr) -> bool {
+  file::mapped_file_t mapped_file;
+  if (!file::map(path, mapped_file)) return false;
+
+  std::string_view text = file::text(mapped_file);
+  std::string_view extension = file::extension(path);
+  if (extension == "rle") return rle::parse(text, function, cancelled);
+  if (extension == "mc") return macrocell::parse(text, function, cancelled);
+
+  for (const auto& [x, y] : parse_plaintext(text, cancelled)) function(x, y);
+  return true;
+}
+
+// the rule a .rle or .mc file was saved with, empty when it does not say or cannot be read
+auto rule(const std::string& path) -> std::string {
+  file::mapped_file_t mapped_file;
+  if (!file::map(path, mapped_file)) return {};
+
+  std::string_view text = file::text(mapped_file);
+  std::string_view extension = file::extension(path);
+  if (extension == "rle") return std::string(rle::header_rule(text));
+  if (extension == "mc") return std::string(macrocell::header_rule(text));
+  return {};
+}
+
+auto load(const std::string& path, coords_t& coords) -> bool {
+  coords.clear();
+  return parse(path, [&coords](const int x, const int y) { coords.emplace_back(x, y); });
+}
+
+// Background Loading ---------------------------
+// the parser runs on its own thread and hands over batches, the owner drains them between frames
+constexpr size_t batch_size = 1 << 16;
+
+struct loader_t {
+  std::thread thread;
+  std::mutex mutex;
+  std::vector<coords_t> batches;
+
+  std::atomic<bool> loading{false};
+  std::atomic<bool> failed{false};
+  std::atomic<bool> cancelled{false};
+  std::atomic<size_t> parsed{0};
+  std::string path;
+
+  ~loader_t() {
+    cancelled = true;
+    if (thread.joinable()) thread.join();
+  }
+};
+
+auto flush(loader_t& loader, coords_t& batch) -> void {
+  if (batch.empty()) return;
+
+  std::scoped_lock lock(loader.mutex);
+  loader.batches.push_back(std::move(batch));
+  batch = coords_t();
+  batch.reserve(batch_size);
+}
+
+auto work(loader_t& loader) -> void {
+  coords_t batch;
+  batch.reserve(batch_size);
+
+  bool parsed = parse(
+      loader.path,
+      [&loader, &batch](const int x, const int y) {
+        if (loader.cancelled) return;
+        batch.emplace_back(x, y);
+        ++loader.parsed;
+        if (batch.size() == batch_size) flush(loader, batch);
+      },
+      &loader.cancelled);
+
+  flush(loader, batch);
+  loader.failed = !parsed;
+  loader.loading = false;
+}
+
+// cancels a load in progress, the parser checks cancelled as it goes and stops within a row or node
+auto cancel(loader_t& loader) -> void {
+  loader.cancelled = true;
+  if (loader.thread.joinable()) loader.thread.join();
+
+  loader.batches.clear();
+  loader.cancelled = false;
+}
+
+auto start(loader_t& loader, const std::string& path) -> void {
+  cancel(loader);
+
+  loader.path = path;
+  loader.parsed = 0;
+  loader.failed = false;
+  loader.loading = true;
+  loader.thread = std::thread(work, std::ref(loader));
+}
+
+// calls function(x, y) for every cell parsed since the last drain
+template <typename function_t>
+auto drain(loader_t& loader, function_t&& function) -> void {
+  std::vector<coords_t> batches;
+  {
+    std::scoped_lock lock(loader.mutex);
+    batches.swap(loader.batches);
+  }
+
+  for (const auto& batch : batches) {
+    for (const auto& [x, y] : batch) function(x, y);
+  }
+}
+
+// true until the parser has finished and every batch has been drained
+auto pending(loader_t& loader) -> bool {
+  if (loader.loading) return true;
+
+  std::scoped_lock lock(loader.mutex);
+  return !loader.batches.empty();
+}
+// ----------------------------------------------
+
+}  // namespace pattern::loader
@@ -0,0 +1,227 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Pattern Macrocell Functions
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <cstdio>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#include "fmt/format.h"
+
+#include "engine_hashlife.hpp"
+
+namespace pattern::macrocell {
+
+// level 3 nodes are 8x8 leaves, bit (y * 8 + x)
+struct node_t {
+  uint8_t level;
+  std::array<uint32_t, 4> children;
+  uint64_t bits;
+};
+
+// node 0 is the empty node of any level, the file numbers its nodes from 1
+struct reader_t {
+  std::vector<node_t> nodes{node_t{}};
+};
+
+auto parse_leaf(std::string_view line, node_t& node) -> void {
+  node.level = 3;
+  node.bits = 0;
+  int x = 0;
+  int y = 0;
+  for (const char character : line) {
+    if (character == '$') {
+      ++y;
+      x = 0;
+    } else if (character == '*') {
+      if (x < 8 && y < 8) node.bits |= uint64_t{1} << (y * 8 + x);
+      ++x;
+    } else if (character == '.') {
+      ++x;
+    }
+  }
+}
+
+auto parse_node(std::string_view line, node_t& node) -> bool {
+  std::array<uint32_t, 5> values;
+  const char* position = line.data();
+  const char* end = line.data() + line.size();
+  for (auto& value : values) {
+    while (position < end && *position == ' ') ++position;
+    auto [next, error] = std::from_chars(position, end, value);
+    if (error != std::errc()) return false;
+    position = next;
+  }
+
+  // levels past 63 would overflow the coordinates
+  if (values[0] < 4 || values[0] > 63) return false;
+  node.level = static_cast<uint8_t>(values[0]);
+  node.children = {values[1], values[2], values[3], values[4]};
+  return true;
+}
+
+template <typename function_t>
+auto emit(const reader_t& reader, const uint32_t index, const int64_t x, const int64_t y, function_t& function, const std::atomic<bool>* cancelled) -> void {
+  if (index == 0) return;
+  const node_t& node = reader.nodes[index];
+
+  if (node.level == 3) {
+    for (uint64_t bits = node.bits; bits != 0; bits &= bits - 1) {
+      int bit = std::countr_zero(bits);
+      int64_t cell_x = x + (bit & 7);
+      int64_t cell_y = y + (bit >> 3);
+      if (cell_x < std::numeric_limits<int>::min() || cell_x > std::numeric_limits<int>::max()) continue;
+      if (cell_y < std::numeric_limits<int>::min() || cell_y > std::numeric_limits<int>::max()) continue;
+      function(static_cast<int>(cell_x), static_cast<int>(cell_y));
+    }
+    return;
+  }
+  if (cancelled != nullptr && cancelled->load(std::memory_order_relaxed)) return;
+
+  int64_t half_size = int64_t{1} << (node.level - 1);
+  emit(reader, node.children[0], x, y, function, cancelled);
+  emit(reader, node.children[1], x + half_size, y, function, cancelled);
+  emit(reader, node.children[2], x, y + half_size, function, cancelled);
+  emit(reader, node.children[3], x + half_size, y + half_size, function, cancelled);
+}
+
+// the #R line among the ones before the first node, empty when there is none
+auto header_rule(std::string_view text) -> std::string_view {
+  if (!text.starts_with("[M2]")) return {};
+  while (!text.empty()) {
+    size_t end = text.find('\n');
+    std::string_view line = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+
+    if (!line.starts_with('[') && !line.starts_with('#')) return {};
+    if (!line.starts_with("#R")) continue;
+    line.remove_prefix(2);
+    size_t begin = line.find_first_not_of(" \t");
+    if (begin == std::string_view::npos) return {};
+    line.remove_prefix(begin);
+    return line.substr(0, line.find_last_not_of(" \t\r") + 1);
+  }
+  return {};
+}
+
+// the text is walked once line by line and only the node table is kept, the
+// last node is the root, centred on the origin, a set cancelled stops it at the next node
+template <typename function_t>
+auto parse(std::string_view text, function_t&& function, const std::atomic<bool>* cancelled = nullptr) -> bool {
+  if (!text.starts_with("[M2]")) return false;
+
+  reader_t reader;
+  size_t position = 0;
+  while (position < text.size()) {
+    if (cancelled != nullptr && cancelled->load(std::memory_order_relaxed)) return true;
+    size_t end = text.find('\n', position);
+    if (end == std::string_view::npos) end = text.size();
+    std::string_view line = text.substr(position, end - position);
+    position = end + 1;
+
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    if (line.empty() || line.starts_with('[') || line.starts_with('#')) continue;
+
+    node_t node;
+    if (line.front() == '.' || line.front() == '*' || line.front() == '$') {
+      parse_leaf(line, node);
+    } else if (!parse_node(line, node)) {
+      return false;
+    }
+
+    // every child is an earlier node a level below, or the empty node
+    for (const auto child : node.children) {
+      if (node.level == 3 || child == 0) continue;
+      if (child >= reader.nodes.size() || reader.nodes[child].level != node.level - 1) return false;
+    }
+    reader.nodes.push_back(node);
+  }
+
+  if (reader.nodes.size() < 2) return true;
+
+  uint32_t root = static_cast<uint32_t>(reader.nodes.size() - 1);
+  int64_t origin = -(int64_t{1} << (reader.nodes[root].level - 1));
+  emit(reader, root, origin, origin, function, cancelled);
+  return true;
+}
+
+// Writer Functions -----------------------------
+// nodes are written children first, each node once, numbered as they are written
+struct writer_t {
+  std::FILE* file;
+  std::vector<uint32_t> numbers;
+  uint32_t written{0};
+};
+
+auto leaf_bits(const engine::hashlife::hashlife_t& hashlife, const uint32_t index, const int x, const int y, const int size, uint64_t& bits) -> void {
+  const auto& node = hashlife.nodes[index];
+  if (node.population == 0) return;
+  if (size == 1) {
+    bits |= uint64_t{1} << (y * 8 + x);
+    return;
+  }
+
+  int half_size = size >> 1;
+  leaf_bits(hashlife, node.nw, x, y, half_size, bits);
+  leaf_bits(hashlife, node.ne, x + half_size, y, half_size, bits);
+  leaf_bits(hashlife, node.sw, x, y + half_size, half_size, bits);
+  leaf_bits(hashlife, node.se, x + half_size, y + half_size, half_size, bits);
+}
+
+auto write_node(writer_t& writer, const engine::hashlife::hashlife_t& hashlife, const uint32_t index) -> uint32_t {
+  const auto& node = hashlife.nodes[index];
+  if (node.population == 0) return 0;
+  if (writer.numbers[index] != 0) return writer.numbers[index];
+
+  if (node.level == 3) {
+    uint64_t bits = 0;
+    leaf_bits(hashlife, index, 0, 0, 8, bits);
+
+    char line[8 * 9 + 2];
+    int length = 0;
+    int pending_rows = 0;
+    for (int y = 0; y < 8; ++y) {
+      uint64_t row = (bits >> (y * 8)) & 0xFF;
+      if (row == 0) {
+        ++pending_rows;
+        continue;
+      }
+      for (; pending_rows > 0; --pending_rows) line[length++] = '$';
+      for (int x = 0; x < 8 - std::countl_zero(static_cast<uint8_t>(row)); ++x) line[length++] = (row >> x) & 1 ? '*' : '.';
+      pending_rows = 1;
+    }
+    line[length++] = '$';
+    line[length++] = '\n';
+    std::fwrite(line, 1, length, writer.file);
+  } else {
+    uint32_t nw = write_node(writer, hashlife, node.nw);
+    uint32_t ne = write_node(writer, hashlife, node.ne);
+    uint32_t sw = write_node(writer, hashlife, node.sw);
+    uint32_t se = write_node(writer, hashlife, node.se);
+    fmt::print(writer.file, "{} {} {} {} {}\n", node.level, nw, ne, sw, se);
+  }
+
+  writer.numbers[index] = ++writer.written;
+  return writer.written;
+}
+
+// the rule is written as given, so a larger than life board keeps its own
+auto write(std::FILE* file, const engine::hashlife::hashlife_t& hashlife, const std::string_view rule, const uint64_t generation = 0) -> void {
+  fmt::print(file, "[M2] (life)\n#R {}\n", rule);
+  if (generation != 0) fmt::print(file, "#G {}\n", generation);
+
+  writer_t writer{file, std::vector<uint32_t>(hashlife.nodes.size(), 0)};
+  write_node(writer, hashlife, hashlife.root);
+}
+// ----------------------------------------------
+
+}  // namespace pattern::macrocell
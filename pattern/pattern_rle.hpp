@@ -0,0 +1,179 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Pattern RLE Functions
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#include "fmt/format.h"
+
+namespace pattern::rle {
+
+// the "#R x y" comment places the top left corner of the pattern
+auto parse_offset(std::string_view line, int& offset_x, int& offset_y) -> void {
+  const char* position = line.data() + 2;
+  const char* end = line.data() + line.size();
+  for (int* value : {&offset_x, &offset_y}) {
+    while (position < end && *position == ' ') ++position;
+    auto [next, error] = std::from_chars(position, end, *value);
+    if (error != std::errc()) return;
+    position = next;
+  }
+}
+
+// the rule = .. field of the x = .., y = .. header, empty when there is none, it runs to the end
+// of the line as larger than life rules hold commas of their own
+auto header_rule(std::string_view text) -> std::string_view {
+  while (!text.empty()) {
+    size_t end = text.find('\n');
+    std::string_view line = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+
+    if (line.starts_with('#') || line.find_first_not_of(" \t\r") == std::string_view::npos) continue;
+    if (!line.starts_with('x')) return {};
+
+    size_t rule = line.find("rule");
+    if (rule == std::string_view::npos) return {};
+    line.remove_prefix(rule + 4);
+    size_t begin = line.find_first_not_of(" \t=");
+    if (begin == std::string_view::npos) return {};
+    line.remove_prefix(begin);
+    return line.substr(0, line.find_last_not_of(" \t\r") + 1);
+  }
+  return {};
+}
+
+// calls function(x, y) for every live cell, walking the text once without copying it
+// returns false when the text is not run length encoded, a set cancelled stops it at the next row
+template <typename function_t>
+auto parse(std::string_view text, function_t&& function, const std::atomic<bool>* cancelled = nullptr) -> bool {
+  size_t position = 0;
+  bool header = false;
+  int offset_x = 0;
+  int offset_y = 0;
+
+  // comments and the x = .., y = .. header
+  while (position < text.size()) {
+    size_t end = text.find('\n', position);
+    if (end == std::string_view::npos) end = text.size();
+    std::string_view line = text.substr(position, end - position);
+
+    if (line.starts_with("#R")) parse_offset(line, offset_x, offset_y);
+    if (line.starts_with('#') || line.find_first_not_of(" \t\r") == std::string_view::npos) {
+      position = end + 1;
+      continue;
+    }
+    if (line.starts_with('x')) {
+      header = true;
+      position = end + 1;
+    }
+    break;
+  }
+  if (!header) return false;
+
+  int x = offset_x;
+  int y = offset_y;
+  int count = 0;
+  for (; position < text.size(); ++position) {
+    char character = text[position];
+    if (std::isdigit(static_cast<unsigned char>(character))) {
+      if (count > (std::numeric_limits<int>::max() - (character - '0')) / 10) return false;
+      count = count * 10 + (character - '0');
+      continue;
+    }
+
+    int run = count == 0 ? 1 : count;
+    count = 0;
+
+    if (character == '!') break;
+
+    // a run that carries the pattern past the range of int is refused
+    int& along = character == '$' ? y : x;
+    if (int64_t{along} + run > std::numeric_limits<int>::max()) return false;
+
+    if (character == '$') {
+      if (cancelled != nullptr && cancelled->load(std::memory_order_relaxed)) break;
+      y += run;
+      x = offset_x;
+    } else if (character == 'b' || character == '.') {
+      x += run;
+    } else if (std::isalpha(static_cast<unsigned char>(character))) {
+      for (int cell = 0; cell < run; ++cell) function(x + cell, y);
+      x += run;
+    }
+  }
+  return true;
+}
+
+// Writer Functions -----------------------------
+// lines are wrapped at 70 characters as the format recommends
+struct writer_t {
+  std::FILE* file;
+  int line_length{0};
+};
+
+auto write_run(writer_t& writer, int run, const char tag) -> void {
+  if (run == 0) return;
+
+  char buffer[16];
+  int length = run == 1 ? std::snprintf(buffer, sizeof(buffer), "%c", tag) : std::snprintf(buffer, sizeof(buffer), "%d%c", run, tag);
+  if (writer.line_length + length > 70) {
+    std::fputc('\n', writer.file);
+    writer.line_length = 0;
+  }
+  std::fwrite(buffer, 1, length, writer.file);
+  writer.line_length += length;
+}
+
+// writes the coordinates in row order, the pattern keeps its absolute position through the header
+auto write(std::FILE* file, std::vector<std::pair<int, int>> coords, const std::string_view rule = "B3/S23") -> void {
+  std::ranges::sort(coords, [](const auto& a, const auto& b) { return std::tie(a.second, a.first) < std::tie(b.second, b.first); });
+  coords.erase(std::unique(std::begin(coords), std::end(coords)), std::end(coords));
+
+  int min_x = 0, max_x = -1, min_y = 0, max_y = -1;
+  if (!coords.empty()) {
+    auto [min_coord_x, max_coord_x] = std::ranges::minmax_element(coords, {}, &std::pair<int, int>::first);
+    min_x = min_coord_x->first;
+    max_x = max_coord_x->first;
+    min_y = coords.front().second;
+    max_y = coords.back().second;
+  }
+
+  fmt::print(file, "#R {} {}\n", min_x, min_y);
+  fmt::print(file, "x = {}, y = {}, rule = {}\n", max_x - min_x + 1, max_y - min_y + 1, rule);
+
+  writer_t writer{file};
+  int x = min_x;
+  int y = min_y;
+  int alive = 0;
+  for (const auto& [coord_x, coord_y] : coords) {
+    if (coord_y != y || coord_x != x) {
+      write_run(writer, alive, 'o');
+      alive = 0;
+    }
+    if (coord_y != y) {
+      write_run(writer, coord_y - y, '$');
+      y = coord_y;
+      x = min_x;
+    }
+    write_run(writer, coord_x - x, 'b');
+    ++alive;
+    x = coord_x + 1;
+  }
+  write_run(writer, alive, 'o');
+  std::fputs("!\n", file);
+}
+// ----------------------------------------------
+
+}  // namespace pattern::rle
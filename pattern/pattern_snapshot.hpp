@@ -0,0 +1,264 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Pattern Snapshot Functions
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "engine_cell.hpp"
+#include "engine_sparse.hpp"
+#include "pattern_file.hpp"
+
+namespace pattern::snapshot {
+
+// a snapshot is the header, the tiles and then optionally one rgb triple per live cell in the
+// order the tiles' bits enumerate them, every section starts on an eight byte boundary and is
+// stored in the machine's byte order so a mapped file is read in place
+constexpr std::array<char, 8> magic{'L', 'I', 'F', 'E', 'S', 'N', 'A', 'P'};
+constexpr uint32_t version = 1;
+constexpr uint32_t colored_flag = 1;
+
+constexpr int tile_shift = 6;
+constexpr int tile_size = 1 << tile_shift;
+constexpr int tile_mask = tile_size - 1;
+
+struct header_t {
+  std::array<char, 8> magic;
+  uint32_t version;
+  uint32_t flags;
+  uint64_t generation;
+  uint64_t population;
+  uint64_t tile_count;
+  uint64_t tiles_offset;
+  uint64_t colors_offset;
+  uint64_t file_size;
+  uint64_t checksum;
+
+  // the rulestring, nul padded
+  std::array<char, 64> rule;
+};
+
+// bit n of rows[row] is cell (x * 64 + n, y * 64 + row)
+struct tile_t {
+  int32_t x;
+  int32_t y;
+  std::array<uint64_t, tile_size> rows;
+};
+
+static_assert(sizeof(header_t) % 8 == 0 && sizeof(tile_t) % 8 == 0);
+
+auto align(const uint64_t offset) -> uint64_t { return (offset + 7) & ~uint64_t{7}; }
+
+// folds whole words, the sections are padded so every one is a whole number of words
+auto checksum(uint64_t hash, const void* data, const size_t size) -> uint64_t {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  for (size_t offset = 0; offset < size; offset += 8) {
+    uint64_t word;
+    std::memcpy(&word, bytes + offset, 8);
+    hash = std::rotl(hash ^ word, 29) * 0x9E3779B97F4A7C15ull;
+  }
+  return hash;
+}
+
+// Reader Functions -----------------------------
+// the file stays mapped while it is read, nothing is copied until the cells are emitted
+struct view_t {
+  file::mapped_file_t file;
+  const header_t* header{nullptr};
+  const tile_t* tiles{nullptr};
+  const uint8_t* colors{nullptr};
+};
+
+auto rule(const view_t& view) -> std::string_view {
+  const auto& rule = view.header->rule;
+  return std::string_view(rule.data(), strnlen(rule.data(), rule.size()));
+}
+
+auto colored(const view_t& view) -> bool { return view.header->flags & colored_flag; }
+
+// maps the file and checks its layout and checksum, false when it is not a snapshot this build can read
+auto open(const std::string& path, view_t& view) -> bool {
+  if (!file::map(path, view.file) || view.file.size < sizeof(header_t)) return false;
+
+  const auto* base = static_cast<const uint8_t*>(view.file.data);
+  const auto* header = reinterpret_cast<const header_t*>(base);
+  if (header->magic != magic || header->version != version || header->file_size != view.file.size) return false;
+
+  uint64_t color_bytes = header->flags & colored_flag ? align(header->population * 3) : 0;
+  if (header->tiles_offset != align(sizeof(header_t)) || header->tile_count > (view.file.size - header->tiles_offset) / sizeof(tile_t)) return false;
+  if (header->colors_offset != header->tiles_offset + header->tile_count * sizeof(tile_t) || header->colors_offset + color_bytes != view.file.size) return false;
+  if (std::memchr(header->rule.data(), '\0', header->rule.size()) == nullptr) return false;
+
+  const auto* tiles = reinterpret_cast<const tile_t*>(base + header->tiles_offset);
+  uint64_t population = 0;
+  for (uint64_t index = 0; index < header->tile_count; ++index)
+    for (const uint64_t row : tiles[index].rows) population += std::popcount(row);
+  if (population != header->population) return false;
+
+  uint64_t hash = checksum(0, tiles, header->tile_count * sizeof(tile_t));
+  if (checksum(hash, base + header->colors_offset, color_bytes) != header->checksum) return false;
+
+  view.header = header;
+  view.tiles = tiles;
+  view.colors = base + header->colors_offset;
+  return true;
+}
+
+// calls function(x, y, color) for every live cell, white when the snapshot has no colours
+template <typename function_t>
+auto for_each_cell(const view_t& view, function_t&& function) -> void {
+  const uint8_t* color = view.colors;
+  bool has_colors = colored(view);
+  for (uint64_t index = 0; index < view.header->tile_count; ++index) {
+    const tile_t& tile = view.tiles[index];
+    for (int row = 0; row < tile_size; ++row) {
+      for (uint64_t word = tile.rows[row]; word != 0; word &= word - 1) {
+        int x = tile.x * tile_size + std::countr_zero(word);
+        int y = tile.y * tile_size + row;
+        if (has_colors) {
+          function(x, y, engine::color_t{color[0], color[1], color[2]});
+          color += 3;
+        } else {
+          function(x, y, engine::white);
+        }
+      }
+    }
+  }
+}
+// ----------------------------------------------
+
+// Writer Functions -----------------------------
+// the cells are copied into the writer, then encoded and streamed out on its own thread so the
+// caller only pays for the copy
+struct writer_t {
+  std::thread thread;
+  std::atomic<bool> writing{false};
+  std::atomic<bool> failed{false};
+
+  std::vector<engine::cell_t> cells;
+  uint64_t generation{0};
+  std::string rule;
+  bool colored{true};
+  std::string path;
+
+  // encoding scratch, kept between saves
+  std::vector<tile_t> tiles;
+  engine::sparse::table_t<uint32_t> index;
+  std::vector<uint32_t> cell_tiles;
+  std::vector<std::array<uint64_t, tile_size>> row_starts;
+  std::vector<uint8_t> colors;
+
+  ~writer_t() {
+    if (thread.joinable()) thread.join();
+  }
+};
+
+auto encode(writer_t& writer) -> void {
+  writer.tiles.clear();
+  writer.cell_tiles.resize(writer.cells.size());
+  engine::sparse::clear(writer.index);
+  for (size_t cell = 0; cell < writer.cells.size(); ++cell) {
+    const auto& [x, y] = writer.cells[cell].coord;
+    auto [found, inserted] = engine::sparse::insert(writer.index, engine::pack_coord(x >> tile_shift, y >> tile_shift));
+    if (inserted) {
+      *found = static_cast<uint32_t>(writer.tiles.size());
+      writer.tiles.push_back(tile_t{x >> tile_shift, y >> tile_shift, {}});
+    }
+    writer.tiles[*found].rows[y & tile_mask] |= uint64_t{1} << (x & tile_mask);
+    writer.cell_tiles[cell] = *found;
+  }
+
+  writer.colors.clear();
+  if (!writer.colored) return;
+
+  // a cell's colour goes at its tile's first colour, plus the live cells in the rows above, plus those left of it
+  writer.row_starts.resize(writer.tiles.size());
+  uint64_t start = 0;
+  for (size_t tile = 0; tile < writer.tiles.size(); ++tile) {
+    for (int row = 0; row < tile_size; ++row) {
+      writer.row_starts[tile][row] = start;
+      start += std::popcount(writer.tiles[tile].rows[row]);
+    }
+  }
+
+  writer.colors.assign(align(start * 3), 0);
+  for (size_t cell = 0; cell < writer.cells.size(); ++cell) {
+    const auto& [coord, color] = writer.cells[cell];
+    uint32_t tile = writer.cell_tiles[cell];
+    int row = coord.second & tile_mask;
+    uint64_t left = writer.tiles[tile].rows[row] & ((uint64_t{1} << (coord.first & tile_mask)) - 1);
+    uint64_t offset = (writer.row_starts[tile][row] + std::popcount(left)) * 3;
+    std::copy(std::begin(color), std::end(color), writer.colors.data() + offset);
+  }
+}
+
+// the file is written beside the path and renamed over it once it is on disk, so a crash mid write
+// leaves the earlier snapshot whole
+auto write(writer_t& writer) -> bool {
+  encode(writer);
+
+  std::string temporary = writer.path + ".tmp";
+  std::FILE* file = std::fopen(temporary.c_str(), "wb");
+  if (file == nullptr) return false;
+  std::setvbuf(file, nullptr, _IOFBF, size_t{1} << 20);
+
+  header_t header{};
+  header.magic = magic;
+  header.version = version;
+  header.flags = writer.colored ? colored_flag : 0;
+  header.generation = writer.generation;
+  header.population = 0;
+  for (const auto& tile : writer.tiles)
+    for (const uint64_t row : tile.rows) header.population += std::popcount(row);
+  header.tile_count = writer.tiles.size();
+  header.tiles_offset = align(sizeof(header_t));
+  header.colors_offset = header.tiles_offset + header.tile_count * sizeof(tile_t);
+  header.file_size = header.colors_offset + writer.colors.size();
+  header.checksum = checksum(checksum(0, writer.tiles.data(), writer.tiles.size() * sizeof(tile_t)), writer.colors.data(), writer.colors.size());
+  std::memcpy(header.rule.data(), writer.rule.data(), std::min(writer.rule.size(), header.rule.size() - 1));
+
+  bool written = std::fwrite(&header, sizeof(header), 1, file) == 1;
+  written = written && std::fwrite(writer.tiles.data(), sizeof(tile_t), writer.tiles.size(), file) == writer.tiles.size();
+  written = written && std::fwrite(writer.colors.data(), 1, writer.colors.size(), file) == writer.colors.size();
+  written = written && std::fflush(file) == 0 && fsync(fileno(file)) == 0;
+  written = std::fclose(file) == 0 && written;
+  written = written && std::rename(temporary.c_str(), writer.path.c_str()) == 0;
+  if (!written) std::remove(temporary.c_str());
+  return written;
+}
+
+// false while an earlier save is still being written
+template <typename cells_t>
+auto save(writer_t& writer, const std::string& path, const cells_t& cells, const uint64_t generation, const std::string_view rule, const bool colored) -> bool {
+  if (writer.writing) return false;
+  if (writer.thread.joinable()) writer.thread.join();
+
+  writer.cells.assign(std::begin(cells), std::end(cells));
+  writer.generation = generation;
+  writer.rule = rule;
+  writer.colored = colored;
+  writer.path = path;
+  writer.failed = false;
+  writer.writing = true;
+  writer.thread = std::thread([&writer] {
+    writer.failed = !write(writer);
+    writer.writing = false;
+  });
+  return true;
+}
+// ----------------------------------------------
+
+}  // namespace pattern::snapshot
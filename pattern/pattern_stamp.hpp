@@ -0,0 +1,104 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Pattern Stamp Functions
+
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "pattern.hpp"
+#include "pattern_file.hpp"
+#include "pattern_loader.hpp"
+#include "pattern_rle.hpp"
+
+namespace pattern::stamp {
+
+// a pattern placed by its centre, the coords are kept relative to it
+struct stamp_t {
+  std::string name;
+  coords_t coords;
+};
+
+// quarter turns in the low two bits, a reflection in the third, the reflection is applied first
+constexpr int orientations = 8;
+
+auto rotation(const int orientation) -> int { return (orientation & 3) * 90; }
+
+auto reflected(const int orientation) -> bool { return orientation & 4; }
+
+auto rotate(const int orientation) -> int { return (orientation & 4) | ((orientation + 1) & 3); }
+
+auto reflect(const int orientation) -> int { return orientation ^ 4; }
+
+// shifts the middle of the bounding box onto the origin, rounding towards the top left
+auto centre(coords_t coords) -> coords_t {
+  if (coords.empty()) return coords;
+  auto [min_x, min_y] = coords.front();
+  auto [max_x, max_y] = coords.front();
+  for (const auto& [x, y] : coords) {
+    min_x = std::min(min_x, x);
+    min_y = std::min(min_y, y);
+    max_x = std::max(max_x, x);
+    max_y = std::max(max_y, y);
+  }
+  return translate(std::move(coords), -(min_x + (max_x - min_x) / 2), -(min_y + (max_y - min_y) / 2));
+}
+
+auto make(std::string name, coords_t coords) -> stamp_t { return stamp_t{std::move(name), centre(std::move(coords))}; }
+
+auto make_rle(std::string name, std::string_view text) -> stamp_t {
+  coords_t coords;
+  rle::parse(text, [&coords](const int x, const int y) { coords.emplace_back(x, y); });
+  return make(std::move(name), std::move(coords));
+}
+
+// the stamps every program starts with, the r-pentomino first as it was the only one
+auto builtin() -> std::vector<stamp_t> {
+  return {
+      make("r-pentomino", rpentomino(0, 0)),
+      make_rle("glider", "x = 3, y = 3\nbo$2bo$3o!\n"),
+      make_rle("lightweight spaceship", "x = 5, y = 4\nbo2bo$o4b$o3bo$4o!\n"),
+      make("acorn", acorn()),
+      make("gosper glider gun", gosper_glider_gun()),
+      make_rle("pulsar", "x = 13, y = 13\n2b3o3b3o2$o4bobo4bo$o4bobo4bo$o4bobo4bo$2b3o3b3o2$2b3o3b3o$o4bobo4bo$o4bobo4bo$o4bobo4bo2$2b3o3b3o!\n"),
+  };
+}
+
+// any pattern file the loader reads, named after the file
+auto load(const std::string& path, stamp_t& stamp) -> bool {
+  coords_t coords;
+  if (!loader::load(path, coords)) return false;
+
+  std::string_view name = path;
+  if (size_t slash = name.rfind('/'); slash != std::string_view::npos) name.remove_prefix(slash + 1);
+  stamp = make(std::string(name), std::move(coords));
+  return true;
+}
+
+// a quarter turn takes (x, y) to (-y, x), clockwise on screen where y grows downwards
+auto transform(int x, int y, const int orientation) -> std::pair<int, int> {
+  if (reflected(orientation)) x = -x;
+  for (int turn = 0; turn < (orientation & 3); ++turn) {
+    int turned = -y;
+    y = x;
+    x = turned;
+  }
+  return {x, y};
+}
+
+// calls function(x, y) for every cell of the stamp turned to orientation and centred on x, y
+template <typename function_t>
+auto for_each_cell(const stamp_t& stamp, const int orientation, const int x, const int y, function_t&& function) -> void {
+  for (const auto& [coord_x, coord_y] : stamp.coords) {
+    auto [turned_x, turned_y] = transform(coord_x, coord_y, orientation);
+    function(x + turned_x, y + turned_y);
+  }
+}
+
+}  // namespace pattern::stamp
@@ -0,0 +1,248 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Profile Functions
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+#include "fmt/format.h"
+
+namespace profile {
+
+// built with LIFE_PROFILE off, timers and counters compile to nothing
+#if defined(LIFE_PROFILE)
+constexpr bool enabled = true;
+#else
+constexpr bool enabled = false;
+#endif
+
+enum struct timer_e : uint8_t { frame, update_console, update_display, update_loader, update_cells, engine_step, engine_cells, pool_work, render_console, render_display };
+enum struct counter_e : uint8_t { births, deaths, candidates, allocations };
+
+constexpr int timer_count = 10;
+constexpr int counter_count = 4;
+
+constexpr std::array<std::string_view, timer_count> timer_names{"frame", "update_console", "update_display", "update_loader", "update_cells", "engine_step", "engine_cells", "pool_work", "render_console", "render_display"};
+constexpr std::array<std::string_view, counter_count> counter_names{"births", "deaths", "candidates", "allocations"};
+
+// the most recent samples of each timer, the histogram rolls over once the window is full
+constexpr size_t window = 1024;
+
+struct histogram_t {
+  std::array<std::atomic<uint64_t>, window> samples{};
+  std::atomic<uint64_t> recorded{0};
+};
+
+struct profile_t {
+  std::array<histogram_t, timer_count> histograms;
+  std::array<std::atomic<uint64_t>, counter_count> counters{};
+};
+
+struct summary_t {
+  uint64_t count{0};
+  uint64_t p50{0};
+  uint64_t p99{0};
+  uint64_t max{0};
+};
+
+auto state() -> profile_t& {
+  static profile_t profile;
+  return profile;
+}
+
+auto record(const timer_e timer, const uint64_t ns) -> void {
+  if constexpr (enabled) {
+    histogram_t& histogram = state().histograms[static_cast<int>(timer)];
+    uint64_t slot = histogram.recorded.fetch_add(1, std::memory_order_relaxed) % window;
+    histogram.samples[slot].store(ns, std::memory_order_relaxed);
+  }
+}
+
+auto count(const counter_e counter, const uint64_t amount = 1) -> void {
+  if constexpr (enabled) state().counters[static_cast<int>(counter)].fetch_add(amount, std::memory_order_relaxed);
+}
+
+auto total(const counter_e counter) -> uint64_t { return state().counters[static_cast<int>(counter)].load(std::memory_order_relaxed); }
+
+// Trace ----------------------------------------
+// while capturing, every timed scope is also kept as an event in its thread's ring, the
+// rings are written out as chrome trace event json for perfetto or chrome://tracing
+namespace trace {
+
+constexpr size_t ring_size = 1 << 16;
+constexpr int max_threads = 64;
+
+struct event_t {
+  std::string_view name;
+  int64_t begin_ns;
+  int64_t end_ns;
+};
+
+// written only by its own thread, the ring storage is allocated once on the thread's first event
+struct ring_t {
+  std::vector<event_t> events;
+  std::atomic<uint64_t> written{0};
+  std::atomic<bool> ready{false};
+  std::string_view name;
+};
+
+struct trace_t {
+  std::array<ring_t, max_threads> rings;
+  std::atomic<int> registered{0};
+  std::atomic<bool> capturing{false};
+  std::atomic<int64_t> epoch_ns{0};
+};
+
+auto state() -> trace_t& {
+  static trace_t trace;
+  return trace;
+}
+
+auto now_ns() -> int64_t { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+
+auto thread_name() -> std::string_view& {
+  thread_local std::string_view name{"thread"};
+  return name;
+}
+
+// names the calling thread in the trace, call before its first event
+auto name_thread(const std::string_view name) -> void { thread_name() = name; }
+
+auto thread_ring() -> ring_t* {
+  thread_local ring_t* ring = nullptr;
+  if (ring != nullptr) return ring;
+
+  int slot = state().registered.fetch_add(1, std::memory_order_relaxed);
+  if (slot >= max_threads) return nullptr;
+
+  ring = &state().rings[slot];
+  ring->events.resize(ring_size);
+  ring->name = thread_name();
+  ring->ready.store(true, std::memory_order_release);
+  return ring;
+}
+
+auto capturing() -> bool { return state().capturing.load(std::memory_order_relaxed); }
+
+auto record(const std::string_view name, const int64_t begin_ns, const int64_t end_ns) -> void {
+  if (!capturing()) return;
+  ring_t* ring = thread_ring();
+  if (ring == nullptr) return;
+
+  uint64_t written = ring->written.load(std::memory_order_relaxed);
+  ring->events[written % ring_size] = event_t{name, begin_ns, end_ns};
+  ring->written.store(written + 1, std::memory_order_release);
+}
+
+// starts a fresh capture, events from before it are dropped
+auto start() -> void {
+  if constexpr (!enabled) return;
+  for (auto& ring : state().rings)
+    if (ring.ready.load(std::memory_order_acquire)) ring.written.store(0, std::memory_order_relaxed);
+  state().epoch_ns.store(now_ns(), std::memory_order_relaxed);
+  state().capturing.store(true, std::memory_order_release);
+}
+
+auto stop() -> void { state().capturing.store(false, std::memory_order_release); }
+
+// the last ring_size events of every thread, timestamps in microseconds from the start of the capture
+auto write(const char* path) -> bool {
+  std::FILE* file = std::fopen(path, "w");
+  if (file == nullptr) return false;
+
+  int64_t epoch_ns = state().epoch_ns.load(std::memory_order_relaxed);
+  int threads = std::min(state().registered.load(std::memory_order_relaxed), max_threads);
+
+  fmt::print(file, "{{\"traceEvents\": [\n");
+  bool first = true;
+  auto separate = [&] {
+    if (!first) fmt::print(file, ",\n");
+    first = false;
+  };
+
+  for (int tid = 0; tid < threads; ++tid) {
+    const ring_t& ring = state().rings[tid];
+    if (!ring.ready.load(std::memory_order_acquire)) continue;
+
+    separate();
+    fmt::print(file, "{{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": {}, \"args\": {{\"name\": \"{}\"}}}}", tid, ring.name);
+
+    uint64_t written = ring.written.load(std::memory_order_acquire);
+    for (uint64_t index = written > ring_size ? written - ring_size : 0; index < written; ++index) {
+      const event_t& event = ring.events[index % ring_size];
+      if (event.begin_ns < epoch_ns) continue;
+      separate();
+      fmt::print(file, "{{\"name\": \"{}\", \"ph\": \"X\", \"pid\": 1, \"tid\": {}, \"ts\": {:.3f}, \"dur\": {:.3f}}}", event.name, tid, (event.begin_ns - epoch_ns) / 1e3, (event.end_ns - event.begin_ns) / 1e3);
+    }
+  }
+
+  fmt::print(file, "\n]}}\n");
+  return std::fclose(file) == 0;
+}
+
+}  // namespace trace
+// ----------------------------------------------
+
+// times the enclosing scope on the monotonic clock
+#if defined(LIFE_PROFILE)
+struct scope_t {
+  timer_e timer;
+  int64_t begin_ns;
+
+  explicit scope_t(const timer_e timer) : timer(timer), begin_ns(trace::now_ns()) {}
+  scope_t(const scope_t&) = delete;
+  auto operator=(const scope_t&) -> scope_t& = delete;
+
+  ~scope_t() {
+    int64_t end_ns = trace::now_ns();
+    record(timer, end_ns - begin_ns);
+    trace::record(timer_names[static_cast<int>(timer)], begin_ns, end_ns);
+  }
+};
+#else
+struct scope_t {
+  explicit scope_t(const timer_e) {}
+};
+#endif
+
+// percentiles over the samples currently in the window, sorted in the caller's scratch buffer
+auto summarize(const timer_e timer, std::vector<uint64_t>& scratch) -> summary_t {
+  const histogram_t& histogram = state().histograms[static_cast<int>(timer)];
+  summary_t summary;
+  summary.count = histogram.recorded.load(std::memory_order_relaxed);
+
+  size_t size = std::min<uint64_t>(summary.count, window);
+  if (size == 0) return summary;
+
+  scratch.resize(size);
+  for (size_t slot = 0; slot < size; ++slot) scratch[slot] = histogram.samples[slot].load(std::memory_order_relaxed);
+  std::ranges::sort(scratch);
+
+  summary.p50 = scratch[size / 2];
+  summary.p99 = scratch[std::min(size - 1, size * 99 / 100)];
+  summary.max = scratch.back();
+  return summary;
+}
+
+// timer percentiles in microseconds and counter totals, one line each
+auto dump(std::FILE* file) -> void {
+  if constexpr (!enabled) return;
+
+  std::vector<uint64_t> scratch;
+  for (int timer = 0; timer < timer_count; ++timer) {
+    summary_t summary = summarize(static_cast<timer_e>(timer), scratch);
+    fmt::print(file, "{}: count {} p50 {:.1f} us p99 {:.1f} us max {:.1f} us\n", timer_names[timer], summary.count, summary.p50 / 1e3, summary.p99 / 1e3, summary.max / 1e3);
+  }
+  for (int counter = 0; counter < counter_count; ++counter) fmt::print(file, "{}: {}\n", counter_names[counter], total(static_cast<counter_e>(counter)));
+}
+
+}  // namespace profile
@@ -0,0 +1,64 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Profile Allocation Functions
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// replaces the global allocation functions, so include it from the program's one translation unit only
+namespace profile::allocation {
+
+struct counters_t {
+  std::atomic<uint64_t> allocations{0};
+  std::atomic<uint64_t> bytes{0};
+};
+
+auto counters() -> counters_t& {
+  static counters_t counters;
+  return counters;
+}
+
+auto note(const size_t size) -> void {
+  counters().allocations.fetch_add(1, std::memory_order_relaxed);
+  counters().bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+// heap allocations and bytes requested by every thread since the program started
+auto allocations() -> uint64_t { return counters().allocations.load(std::memory_order_relaxed); }
+auto bytes() -> uint64_t { return counters().bytes.load(std::memory_order_relaxed); }
+
+// counts the allocations made between construction and a call to allocated,
+// so a caller can check that a warmed up loop no longer touches the heap
+struct watch_t {
+  uint64_t begin{allocations()};
+  uint64_t begin_bytes{bytes()};
+
+  auto allocated() const -> uint64_t { return allocations() - begin; }
+  auto allocated_bytes() const -> uint64_t { return bytes() - begin_bytes; }
+};
+
+}  // namespace profile::allocation
+
+auto operator new(size_t size) -> void* {
+  profile::allocation::note(size);
+  if (void* memory = std::malloc(size == 0 ? 1 : size)) return memory;
+  throw std::bad_alloc();
+}
+
+auto operator new(size_t size, std::align_val_t alignment) -> void* {
+  profile::allocation::note(size);
+  size_t aligned_size = (size + static_cast<size_t>(alignment) - 1) & ~(static_cast<size_t>(alignment) - 1);
+  if (void* memory = std::aligned_alloc(static_cast<size_t>(alignment), aligned_size == 0 ? static_cast<size_t>(alignment) : aligned_size)) return memory;
+  throw std::bad_alloc();
+}
+
+auto operator delete(void* memory) noexcept -> void { std::free(memory); }
+auto operator delete(void* memory, size_t) noexcept -> void { std::free(memory); }
+auto operator delete(void* memory, std::align_val_t) noexcept -> void { std::free(memory); }
+auto operator delete(void* memory, size_t, std::align_val_t) noexcept -> void { std::free(memory); }
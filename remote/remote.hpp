@@ -0,0 +1,59 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Remote Library
+
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "fmt/format.h"
+
+#include "engine_cell.hpp"
+
+namespace remote {
+
+// the plane is published in square regions, each its own topic, so a viewer subscribes to the
+// regions it can see and the publisher's socket filters out the rest
+constexpr int region_shift = 8;
+
+// every region is published whole this often, to resync viewers that missed a message, a viewer
+// that subscribes to a region is sent it whole straight away
+constexpr uint64_t keyframe_interval = 64;
+
+// a tick closes every generation, with the population in its sequence field
+enum struct message_e : uint8_t { delta, keyframe, tick };
+
+// every message is a topic frame, this header and then the changes in the history's encoding,
+// the sequence counts the messages of a region so a viewer knows when it has missed one
+struct header_t {
+  message_e kind;
+  uint8_t colored;
+  uint64_t sequence;
+  uint64_t generation;
+  uint64_t region;
+};
+
+auto region_key(const int x, const int y) -> uint64_t { return engine::pack_coord(x >> region_shift, y >> region_shift); }
+
+auto region_key(const uint64_t key) -> uint64_t {
+  auto [x, y] = engine::unpack_coord(key);
+  return region_key(x, y);
+}
+
+auto topic(const uint64_t region) -> std::string { return fmt::format("r{:016x}", region); }
+
+// the region of a whole topic, false for anything else
+auto parse_topic(const std::string_view topic, uint64_t& region) -> bool {
+  if (topic.size() != 17 || topic.front() != 'r') return false;
+  auto [end, error] = std::from_chars(topic.data() + 1, topic.data() + topic.size(), region, 16);
+  return error == std::errc{} && end == topic.data() + topic.size();
+}
+
+constexpr const char* tick_topic = "t";
+
+}  // namespace remote
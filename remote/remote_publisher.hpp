@@ -0,0 +1,253 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Remote Publisher Functions
+
+#pragma once
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "czmq.h"
+
+#include "engine_cell.hpp"
+#include "engine_history.hpp"
+#include "engine_sparse.hpp"
+#include "remote.hpp"
+
+namespace remote::publisher {
+
+// the changes of one region, gathered before they are sent
+struct bucket_t {
+  uint64_t region;
+  std::vector<engine::history::change_t> births;
+  std::vector<engine::history::change_t> deaths;
+};
+
+// a region is listed once it changes and goes out whole with every round of keyframes, the round
+// that finds it empty sends it empty once, to clear it from viewers that lost track of it, and
+// forgets it, so its sequence starts again should it fill
+struct region_t {
+  uint64_t sequence;
+  bool listed;
+};
+
+struct publisher_t {
+  zsock_t* socket{nullptr};
+  std::string endpoint;
+
+  // held by whichever thread is publishing or serving subscribers
+  std::mutex mutex;
+
+  // only the history's board and diff are used, it records nothing, revision is the engine's as
+  // of the board so a step's changes from that revision are applied instead of diffed
+  engine::history::history_t board;
+  uint64_t revision{~uint64_t{0}};
+  uint64_t generation{0};
+  bool colored{true};
+
+  engine::sparse::table_t<region_t> regions;
+  engine::sparse::table_t<uint32_t> bucket_index;
+  std::vector<bucket_t> buckets;
+  size_t bucket_count{0};
+  std::vector<uint8_t> encoded;
+
+  // sorted regions viewers have just subscribed to
+  std::vector<uint64_t> joined;
+
+  uint64_t ticks{0};
+  uint64_t since_keyframe{keyframe_interval};
+  uint64_t messages{0};
+  uint64_t bytes{0};
+
+  publisher_t() = default;
+  publisher_t(const publisher_t&) = delete;
+  auto operator=(const publisher_t&) -> publisher_t& = delete;
+
+  ~publisher_t() { zsock_destroy(&socket); }
+};
+
+// binds the endpoint, tcp://*:5556 for viewers on other machines, every subscription is read
+// back from the socket so a viewer is sent what it subscribes to without waiting for a keyframe
+auto start(publisher_t& publisher, const std::string& endpoint) -> bool {
+  publisher.endpoint = endpoint;
+  publisher.socket = zsock_new_xpub(endpoint.c_str());
+  if (publisher.socket == nullptr) return false;
+  zsock_set_xpub_verbose(publisher.socket, 1);
+  zsock_set_rcvtimeo(publisher.socket, 0);
+  return true;
+}
+
+auto bucket(publisher_t& publisher, const uint64_t region) -> bucket_t& {
+  auto [index, inserted] = engine::sparse::insert(publisher.bucket_index, region);
+  if (inserted) {
+    *index = static_cast<uint32_t>(publisher.bucket_count++);
+    if (publisher.buckets.size() < publisher.bucket_count) publisher.buckets.emplace_back();
+    bucket_t& bucket = publisher.buckets[*index];
+    bucket.region = region;
+    bucket.births.clear();
+    bucket.deaths.clear();
+  }
+  return publisher.buckets[*index];
+}
+
+auto clear_buckets(publisher_t& publisher) -> void {
+  engine::sparse::clear(publisher.bucket_index);
+  publisher.bucket_count = 0;
+}
+
+auto send(publisher_t& publisher, const std::string& topic, const header_t& header, const std::vector<uint8_t>& payload) -> void {
+  zmsg_t* message = zmsg_new();
+  zmsg_addstr(message, topic.c_str());
+  zmsg_addmem(message, &header, sizeof(header));
+  zmsg_addmem(message, payload.data(), payload.size());
+  publisher.bytes += topic.size() + sizeof(header) + payload.size();
+  ++publisher.messages;
+  zmsg_send(&message, publisher.socket);
+}
+
+// sends the regions of the board whole, every region with cells or listed when only is null, or
+// else just those in only with the sequence they are at, so a viewer's next delta follows on
+auto send_keyframes(publisher_t& publisher, const std::vector<uint64_t>* only) -> void {
+  // the board's table is in hash order, each region's cells have to go out sorted
+  clear_buckets(publisher);
+  const auto& table = publisher.board.cells;
+  for (size_t slot = 0; slot < table.used.size(); ++slot) {
+    if (!table.used[slot]) continue;
+    uint64_t region = region_key(table.keys[slot]);
+    if (only == nullptr || std::ranges::binary_search(*only, region)) bucket(publisher, region).births.emplace_back(table.keys[slot], table.values[slot].color);
+  }
+
+  auto& regions = publisher.regions;
+  if (only != nullptr) {
+    for (const uint64_t region : *only) bucket(publisher, region);
+  } else {
+    for (size_t slot = 0; slot < regions.used.size(); ++slot)
+      if (regions.used[slot] && regions.values[slot].listed) bucket(publisher, regions.keys[slot]);
+  }
+
+  for (size_t index = 0; index < publisher.bucket_count; ++index) {
+    bucket_t& whole = publisher.buckets[index];
+    std::ranges::sort(whole.births, {}, &engine::history::change_t::first);
+    engine::history::encode(whole.births, whole.deaths, publisher.colored, publisher.encoded);
+
+    // a region never changed, or forgotten, is at sequence zero and stays unlisted
+    if (only != nullptr) {
+      const region_t* region = engine::sparse::find(regions, whole.region);
+      uint64_t sequence = region != nullptr ? region->sequence : 0;
+      send(publisher, topic(whole.region), header_t{message_e::keyframe, publisher.colored, sequence, publisher.generation, whole.region}, publisher.encoded);
+      continue;
+    }
+
+    auto [region, inserted] = engine::sparse::insert(regions, whole.region);
+    if (inserted) *region = region_t{0, false};
+    send(publisher, topic(whole.region), header_t{message_e::keyframe, publisher.colored, region->sequence, publisher.generation, whole.region}, publisher.encoded);
+    region->listed = !whole.births.empty();
+  }
+
+  // a region found empty this round has just been sent empty and is forgotten
+  if (only == nullptr) {
+    for (size_t index = 0; index < publisher.bucket_count; ++index)
+      if (publisher.buckets[index].births.empty()) engine::sparse::erase(regions, publisher.buckets[index].region);
+  }
+}
+
+auto send_tick(publisher_t& publisher) -> void {
+  publisher.encoded.clear();
+  send(publisher, tick_topic, header_t{message_e::tick, publisher.colored, publisher.board.cells.size, publisher.generation, ++publisher.ticks}, publisher.encoded);
+}
+
+// reads the subscriptions waiting on the socket, a region subscribed to is sent whole, subscribing
+// to every region runs a round of keyframes and subscribing to the ticks gets the latest one
+auto serve_locked(publisher_t& publisher) -> void {
+  bool all = false;
+  bool ticks = false;
+  publisher.joined.clear();
+  while (zframe_t* frame = zframe_recv(publisher.socket)) {
+    const auto* data = zframe_data(frame);
+    size_t size = zframe_size(frame);
+    if (size > 0 && data[0] == 1) {
+      std::string_view subscribed(reinterpret_cast<const char*>(data) + 1, size - 1);
+      uint64_t region;
+      if (subscribed == tick_topic)
+        ticks = true;
+      else if (subscribed == "r")
+        all = true;
+      else if (parse_topic(subscribed, region))
+        publisher.joined.push_back(region);
+    }
+    zframe_destroy(&frame);
+  }
+
+  if (all) {
+    publisher.since_keyframe = 0;
+    send_keyframes(publisher, nullptr);
+  } else if (!publisher.joined.empty()) {
+    std::ranges::sort(publisher.joined);
+    auto [begin, end] = std::ranges::unique(publisher.joined);
+    publisher.joined.erase(begin, end);
+    send_keyframes(publisher, &publisher.joined);
+  }
+  if (ticks) send_tick(publisher);
+}
+
+// answers new subscribers from any thread, skipped while the board is being published as that
+// serves them itself
+auto serve(publisher_t& publisher) -> void {
+  std::unique_lock lock(publisher.mutex, std::try_to_lock);
+  if (lock.owns_lock()) serve_locked(publisher);
+}
+
+// every region that changed, then every region whole when a keyframe is due, then the tick, the
+// changes are taken from delta when it starts from the board's revision and diffed otherwise
+auto publish(publisher_t& publisher, const std::vector<engine::cell_t>& cells, const uint64_t generation, const bool colored, const uint64_t revision = ~uint64_t{0}, const engine::history::delta_t* delta = nullptr) -> void {
+  std::scoped_lock lock(publisher.mutex);
+
+  // a change of colouring changes the encoding, so everything goes out again as keyframes
+  if (colored != publisher.colored) {
+    publisher.colored = colored;
+    publisher.since_keyframe = keyframe_interval;
+  }
+  publisher.generation = generation;
+
+  auto& board = publisher.board;
+  bool shared = delta != nullptr && delta->from == publisher.revision;
+  if (shared) {
+    engine::history::apply(board, *delta->births, *delta->deaths);
+  } else {
+    engine::history::diff(board, cells);
+  }
+  const auto& births = shared ? *delta->births : board.births;
+  const auto& deaths = shared ? *delta->deaths : board.deaths;
+  publisher.revision = revision;
+
+  clear_buckets(publisher);
+  for (const auto& change : births) bucket(publisher, region_key(change.first)).births.push_back(change);
+  for (const auto& change : deaths) bucket(publisher, region_key(change.first)).deaths.push_back(change);
+
+  for (size_t index = 0; index < publisher.bucket_count; ++index) {
+    const bucket_t& changed = publisher.buckets[index];
+    auto [region, inserted] = engine::sparse::insert(publisher.regions, changed.region);
+    if (inserted) *region = region_t{0, false};
+    region->listed = true;
+    engine::history::encode(changed.births, changed.deaths, colored, publisher.encoded);
+    send(publisher, topic(changed.region), header_t{message_e::delta, colored, ++region->sequence, generation, changed.region}, publisher.encoded);
+  }
+
+  if (++publisher.since_keyframe >= keyframe_interval) {
+    publisher.since_keyframe = 0;
+    send_keyframes(publisher, nullptr);
+  }
+
+  send_tick(publisher);
+  serve_locked(publisher);
+}
+
+// the simulation's observer, publishing from its thread after every change
+auto observe(const std::vector<engine::cell_t>& cells, const uint64_t generation, const bool colored, const uint64_t revision, const engine::history::delta_t* delta, void* context) -> void { publish(*static_cast<publisher_t*>(context), cells, generation, colored, revision, delta); }
+
+}  // namespace remote::publisher
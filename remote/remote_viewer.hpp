@@ -0,0 +1,204 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Remote Viewer Functions
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "czmq.h"
+
+#include "engine_cell.hpp"
+#include "engine_history.hpp"
+#include "engine_sparse.hpp"
+#include "remote.hpp"
+
+namespace remote::viewer {
+
+// a region is in sync from its first keyframe until a message of its goes missing, and then
+// shows nothing until the next keyframe
+struct region_t {
+  uint64_t region;
+  uint64_t sequence;
+  bool synced;
+  engine::sparse::table_t<engine::color_t> cells;
+};
+
+// watching more regions than this subscribes to everything instead
+constexpr size_t max_watched = 4096;
+
+struct viewer_t {
+  zsock_t* socket{nullptr};
+  std::string endpoint;
+
+  std::vector<region_t> regions;
+  engine::sparse::table_t<uint32_t> index;
+
+  // sorted region keys subscribed to, or every region when watching_all
+  std::vector<uint64_t> watched;
+  std::vector<uint64_t> watching;
+  bool watching_all{false};
+
+  std::vector<engine::history::change_t> births;
+  std::vector<engine::history::change_t> deaths;
+
+  uint64_t generation{0};
+  uint64_t population{0};
+
+  // bumped whenever the cells change
+  uint64_t revision{0};
+
+  uint64_t messages{0};
+  uint64_t bytes{0};
+  uint64_t desyncs{0};
+
+  viewer_t() = default;
+  viewer_t(const viewer_t&) = delete;
+  auto operator=(const viewer_t&) -> viewer_t& = delete;
+
+  ~viewer_t() { zsock_destroy(&socket); }
+};
+
+// connects to a publisher, subscribed only to its ticks until watch says what is in view
+auto connect(viewer_t& viewer, const std::string& endpoint) -> bool {
+  viewer.endpoint = endpoint;
+  viewer.socket = zsock_new_sub(endpoint.c_str(), tick_topic);
+  if (viewer.socket == nullptr) return false;
+  zsock_set_rcvtimeo(viewer.socket, 0);
+  return true;
+}
+
+auto find_region(viewer_t& viewer, const uint64_t key) -> region_t& {
+  auto [index, inserted] = engine::sparse::insert(viewer.index, key);
+  if (inserted) {
+    *index = static_cast<uint32_t>(viewer.regions.size());
+    viewer.regions.push_back(region_t{key, 0, false, {}});
+  }
+  return viewer.regions[*index];
+}
+
+auto drop(region_t& region) -> void {
+  engine::sparse::clear(region.cells);
+  region.synced = false;
+}
+
+auto synced_regions(const viewer_t& viewer) -> size_t {
+  return static_cast<size_t>(std::ranges::count_if(viewer.regions, [](const region_t& region) { return region.synced; }));
+}
+
+// applies one message, true when the cells changed
+auto apply(viewer_t& viewer, const header_t& header, zframe_t* payload) -> bool {
+  if (header.kind == message_e::tick) {
+    viewer.population = header.sequence;
+    viewer.generation = header.generation;
+    return false;
+  }
+  if (!engine::history::decode(zframe_data(payload), zframe_size(payload), header.colored, viewer.births, viewer.deaths)) return false;
+
+  region_t& region = find_region(viewer, header.region);
+  if (header.kind == message_e::keyframe) {
+    if (region.synced && region.sequence == header.sequence) return false;
+    engine::sparse::clear(region.cells);
+    for (const auto& [key, color] : viewer.births) *engine::sparse::insert(region.cells, key).first = color;
+    region.sequence = header.sequence;
+    region.synced = true;
+    return true;
+  }
+
+  // a region is empty at sequence zero, where it starts again once the publisher has forgotten
+  // it, so its first delta syncs it whatever came before
+  if (header.sequence == 1) {
+    engine::sparse::clear(region.cells);
+    region.sequence = 0;
+    region.synced = true;
+  }
+  if (!region.synced) return false;
+  if (header.sequence != region.sequence + 1) {
+    drop(region);
+    ++viewer.desyncs;
+    return true;
+  }
+  for (const auto& change : viewer.deaths) engine::sparse::erase(region.cells, change.first);
+  for (const auto& [key, color] : viewer.births) *engine::sparse::insert(region.cells, key).first = color;
+  region.sequence = header.sequence;
+  return true;
+}
+
+// takes every message waiting without blocking, true when the cells changed
+auto update(viewer_t& viewer) -> bool {
+  bool changed = false;
+  while (zmsg_t* message = zmsg_recv(viewer.socket)) {
+    zframe_t* topic = zmsg_pop(message);
+    zframe_t* header_frame = zmsg_pop(message);
+    zframe_t* payload = zmsg_pop(message);
+
+    header_t header;
+    if (header_frame != nullptr && payload != nullptr && zframe_size(header_frame) == sizeof(header)) {
+      std::memcpy(&header, zframe_data(header_frame), sizeof(header));
+      viewer.bytes += zframe_size(topic) + zframe_size(header_frame) + zframe_size(payload);
+      ++viewer.messages;
+      changed = apply(viewer, header, payload) || changed;
+    }
+
+    zframe_destroy(&topic);
+    zframe_destroy(&header_frame);
+    zframe_destroy(&payload);
+    zmsg_destroy(&message);
+  }
+  if (changed) ++viewer.revision;
+  return changed;
+}
+
+// subscribes to the regions over the given cells and drops the ones that went out of view
+auto watch(viewer_t& viewer, const int min_x, const int min_y, const int max_x, const int max_y) -> void {
+  int64_t columns = (int64_t{max_x} >> region_shift) - (min_x >> region_shift) + 1;
+  int64_t rows = (int64_t{max_y} >> region_shift) - (min_y >> region_shift) + 1;
+  bool all = columns * rows > static_cast<int64_t>(max_watched);
+
+  viewer.watching.clear();
+  if (!all) {
+    for (int y = min_y >> region_shift; y <= max_y >> region_shift; ++y)
+      for (int x = min_x >> region_shift; x <= max_x >> region_shift; ++x) viewer.watching.push_back(engine::pack_coord(x, y));
+    std::ranges::sort(viewer.watching);
+  }
+  if (all == viewer.watching_all && viewer.watching == viewer.watched) return;
+
+  for (const uint64_t region : viewer.watched)
+    if (!std::ranges::binary_search(viewer.watching, region)) zsock_set_unsubscribe(viewer.socket, topic(region).c_str());
+  for (const uint64_t region : viewer.watching)
+    if (!std::ranges::binary_search(viewer.watched, region)) zsock_set_subscribe(viewer.socket, topic(region).c_str());
+  if (all != viewer.watching_all) {
+    if (all)
+      zsock_set_subscribe(viewer.socket, "r");
+    else
+      zsock_set_unsubscribe(viewer.socket, "r");
+  }
+
+  // a region no longer subscribed to would only go stale
+  if (!all) {
+    for (auto& region : viewer.regions)
+      if (region.synced && !std::ranges::binary_search(viewer.watching, region.region)) drop(region);
+  }
+
+  std::swap(viewer.watched, viewer.watching);
+  viewer.watching_all = all;
+  ++viewer.revision;
+}
+
+// every cell of the regions in sync
+auto cells(const viewer_t& viewer, std::vector<engine::cell_t>& cells) -> void {
+  cells.clear();
+  for (const auto& region : viewer.regions) {
+    if (!region.synced) continue;
+    const auto& table = region.cells;
+    for (size_t slot = 0; slot < table.used.size(); ++slot)
+      if (table.used[slot]) cells.push_back(engine::cell_t{engine::unpack_coord(table.keys[slot]), table.values[slot]});
+  }
+}
+
+}  // namespace remote::viewer
@@ -0,0 +1,163 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Shard Library
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "czmq.h"
+
+#include "engine_cell.hpp"
+#include "engine_world.hpp"
+
+namespace shard {
+
+// a finite world cut into columns x rows rectangles, each stepped by its own worker, the
+// workers trade their one cell borders with their neighbours every generation
+struct layout_t {
+  engine::world::topology_e topology{engine::world::topology_e::torus};
+  int width{0};
+  int height{0};
+  int columns{1};
+  int rows{1};
+};
+
+struct rect_t {
+  int x;
+  int y;
+  int width;
+  int height;
+};
+
+auto count(const layout_t& layout) -> int { return layout.columns * layout.rows; }
+
+// every shard has to be at least one cell wide and high, or neighbours would disagree on their halos
+auto valid(const layout_t& layout) -> bool { return layout.columns >= 1 && layout.rows >= 1 && layout.columns <= layout.width && layout.rows <= layout.height; }
+
+// the shards split the world as evenly as whole cells allow, with the world's origin at its middle
+auto rect(const layout_t& layout, const int index) -> rect_t {
+  int column = index % layout.columns;
+  int row = index / layout.columns;
+  int begin_x = static_cast<int>(int64_t{column} * layout.width / layout.columns);
+  int end_x = static_cast<int>(int64_t{column + 1} * layout.width / layout.columns);
+  int begin_y = static_cast<int>(int64_t{row} * layout.height / layout.rows);
+  int end_y = static_cast<int>(int64_t{row + 1} * layout.height / layout.rows);
+  return rect_t{begin_x - layout.width / 2, begin_y - layout.height / 2, end_x - begin_x, end_y - begin_y};
+}
+
+// the part of parts owning offset, the inverse of floor(part * total / parts) <= offset
+auto part(const int offset, const int parts, const int total) -> int { return static_cast<int>(((int64_t{offset} + 1) * parts - 1) / total); }
+
+// the shard that owns a coord already confined to the world
+auto owner(const layout_t& layout, const int x, const int y) -> int {
+  int column = part(x + layout.width / 2, layout.columns, layout.width);
+  int row = part(y + layout.height / 2, layout.rows, layout.height);
+  return row * layout.columns + column;
+}
+
+// the shard across the border in direction (delta_x, delta_y), -1 past the edge of a bounded world
+auto neighbour(const layout_t& layout, const int index, const int delta_x, const int delta_y) -> int {
+  int column = index % layout.columns + delta_x;
+  int row = index / layout.columns + delta_y;
+  if (layout.topology == engine::world::topology_e::torus) {
+    column = engine::world::floor_mod(column, layout.columns);
+    row = engine::world::floor_mod(row, layout.rows);
+  } else if (column < 0 || column >= layout.columns || row < 0 || row >= layout.rows) {
+    return -1;
+  }
+  return row * layout.columns + column;
+}
+
+// every socket of a session hangs off one base endpoint, ipc:// for processes or inproc:// for threads
+auto endpoint(const std::string_view base, const std::string_view role, const int index) -> std::string {
+  std::string address(base);
+  address += '-';
+  address += role;
+  address += '-';
+  address += std::to_string(index);
+  return address;
+}
+
+auto threaded(const std::string_view base) -> bool { return base.starts_with("inproc://"); }
+
+// a coordinator or neighbour that has not answered within this many milliseconds is taken to be lost
+constexpr int timeout_ms = 30000;
+
+// Messages -------------------------------------
+// every message is a command string followed by raw frames, the workers run on the same
+// machine as the coordinator so structs travel in its byte order
+struct load_t {
+  layout_t layout;
+  int index;
+  uint16_t birth;
+  uint16_t survival;
+  uint8_t colored;
+  uint64_t generation;
+};
+
+struct stepped_t {
+  uint64_t generation;
+  uint64_t population;
+};
+
+// a halo frame is this header, then size cell bytes, then three channels of size bytes when coloured
+struct halo_t {
+  uint64_t generation;
+  int32_t direction;
+  int32_t size;
+};
+
+// cells travel as their bytes, std::pair only falls short of trivially copyable through its assignment
+static_assert(std::is_trivially_copy_constructible_v<engine::cell_t> && std::is_trivially_destructible_v<engine::cell_t> && std::is_trivially_copyable_v<load_t>);
+
+template <typename value_t>
+auto add(zmsg_t* message, const value_t& value) -> void {
+  zmsg_addmem(message, &value, sizeof(value));
+}
+
+template <typename value_t>
+auto add(zmsg_t* message, const std::vector<value_t>& values) -> void {
+  zmsg_addmem(message, values.data(), values.size() * sizeof(value_t));
+}
+
+// pops the next frame into value, false when it is missing or the wrong size
+template <typename value_t>
+auto pop(zmsg_t* message, value_t& value) -> bool {
+  zframe_t* frame = zmsg_pop(message);
+  bool valid = frame != nullptr && zframe_size(frame) == sizeof(value);
+  if (valid) std::memcpy(&value, zframe_data(frame), sizeof(value));
+  zframe_destroy(&frame);
+  return valid;
+}
+
+template <typename value_t>
+auto pop(zmsg_t* message, std::vector<value_t>& values) -> bool {
+  zframe_t* frame = zmsg_pop(message);
+  bool valid = frame != nullptr && zframe_size(frame) % sizeof(value_t) == 0;
+  if (valid) {
+    values.resize(zframe_size(frame) / sizeof(value_t));
+    std::memcpy(static_cast<void*>(values.data()), zframe_data(frame), zframe_size(frame));
+  }
+  zframe_destroy(&frame);
+  return valid;
+}
+
+// the command a message starts with, empty when there is none
+auto pop_command(zmsg_t* message) -> std::string {
+  char* text = zmsg_popstr(message);
+  if (text == nullptr) return {};
+  std::string command(text);
+  zstr_free(&text);
+  return command;
+}
+// ----------------------------------------------
+
+}  // namespace shard
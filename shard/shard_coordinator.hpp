@@ -0,0 +1,193 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Shard Coordinator Functions
+
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+
+#include "czmq.h"
+
+#include "engine.hpp"
+#include "shard.hpp"
+#include "shard_worker.hpp"
+
+extern char** environ;
+
+namespace shard::coordinator {
+
+// workers behind inproc:// endpoints run as threads of this process, behind any other endpoint
+// they are copies of this program started with --shard-worker
+struct coordinator_t {
+  layout_t layout;
+  std::string base;
+
+  std::vector<zsock_t*> controls;
+  std::vector<std::thread> threads;
+  std::vector<pid_t> processes;
+
+  // scratch, the cells bound for each shard
+  std::vector<std::vector<engine::cell_t>> parts;
+  std::vector<engine::cell_t> gathered;
+
+  uint64_t generation{0};
+  uint64_t population{0};
+
+  // set once a worker stops answering, after which the cells are left as they were
+  bool failed{false};
+
+  coordinator_t() = default;
+  coordinator_t(const coordinator_t&) = delete;
+  auto operator=(const coordinator_t&) -> coordinator_t& = delete;
+
+  ~coordinator_t() { stop(); }
+
+  auto stop() -> void {
+    for (auto& control : controls) {
+      zstr_send(control, "stop");
+      zsock_destroy(&control);
+    }
+    controls.clear();
+    for (auto& thread : threads) thread.join();
+    threads.clear();
+    for (const pid_t process : processes) {
+      if (failed) kill(process, SIGTERM);
+      waitpid(process, nullptr, 0);
+    }
+    processes.clear();
+  }
+};
+
+// binds a control socket per shard and starts the workers, each with threads of its own
+auto start(coordinator_t& coordinator, const std::string& base, const layout_t& layout, const size_t threads) -> bool {
+  coordinator.layout = layout;
+  coordinator.base = base;
+  coordinator.parts.resize(count(layout));
+
+  for (int index = 0; index < count(layout); ++index) {
+    zsock_t* control = zsock_new_pair(("@" + endpoint(base, "control", index)).c_str());
+    if (control == nullptr) return false;
+    zsock_set_rcvtimeo(control, timeout_ms);
+    zsock_set_sndtimeo(control, timeout_ms);
+    coordinator.controls.push_back(control);
+  }
+
+  for (int index = 0; index < count(layout); ++index) {
+    if (threaded(base)) {
+      coordinator.threads.emplace_back([base, index, threads] { worker::run(base, index, threads); });
+      continue;
+    }
+
+    std::string program = "/proc/self/exe";
+    std::string index_text = std::to_string(index);
+    std::string threads_text = std::to_string(threads);
+    std::vector<char*> arguments{program.data(), const_cast<char*>("--shard-worker"), const_cast<char*>(base.c_str()), const_cast<char*>("--shard-index"), index_text.data(), const_cast<char*>("--threads"), threads_text.data(), nullptr};
+    pid_t process;
+    if (posix_spawn(&process, program.c_str(), nullptr, nullptr, arguments.data(), environ) != 0) return false;
+    coordinator.processes.push_back(process);
+  }
+  return true;
+}
+
+// hands every shard the cells inside it, along with the rule and generation to carry on from
+auto load(coordinator_t& coordinator, const std::vector<engine::cell_t>& cells, const uint64_t generation, const engine::rule::rule_t rule, const bool colored) -> void {
+  const layout_t& layout = coordinator.layout;
+  engine::world::world_t bounds;
+  bounds.topology = layout.topology;
+  bounds.width = layout.width;
+  bounds.height = layout.height;
+  bounds.origin_x = -(layout.width / 2);
+  bounds.origin_y = -(layout.height / 2);
+
+  for (auto& part : coordinator.parts) part.clear();
+  for (auto cell : cells) {
+    if (!engine::world::confine(bounds, cell.coord.first, cell.coord.second)) continue;
+    coordinator.parts[owner(layout, cell.coord.first, cell.coord.second)].push_back(cell);
+  }
+
+  for (int index = 0; index < count(layout); ++index) {
+    zmsg_t* message = zmsg_new();
+    zmsg_addstr(message, "load");
+    add(message, load_t{layout, index, rule.birth, rule.survival, static_cast<uint8_t>(colored), generation});
+    add(message, coordinator.parts[index]);
+    zmsg_send(&message, coordinator.controls[index]);
+  }
+  coordinator.generation = generation;
+}
+
+// sends every command before waiting on any reply so the shards work side by side
+auto broadcast(coordinator_t& coordinator, const char* command, const uint64_t* argument) -> void {
+  for (zsock_t* control : coordinator.controls) {
+    zmsg_t* message = zmsg_new();
+    zmsg_addstr(message, command);
+    if (argument != nullptr) add(message, *argument);
+    zmsg_send(&message, control);
+  }
+}
+
+auto receive(coordinator_t& coordinator, const int index, const char* expected) -> zmsg_t* {
+  zmsg_t* message = zmsg_recv(coordinator.controls[index]);
+  if (message != nullptr && pop_command(message) == expected) return message;
+  zmsg_destroy(&message);
+  coordinator.failed = true;
+  return nullptr;
+}
+
+// advances every shard count generations, false unless they all arrive at the same one
+auto step(coordinator_t& coordinator, const uint64_t count) -> bool {
+  if (coordinator.failed) return false;
+  broadcast(coordinator, "step", &count);
+
+  coordinator.population = 0;
+  for (size_t index = 0; index < coordinator.controls.size(); ++index) {
+    zmsg_t* message = receive(coordinator, static_cast<int>(index), "stepped");
+    stepped_t stepped{};
+    if (message == nullptr || !pop(message, stepped) || stepped.generation != coordinator.generation + count) coordinator.failed = true;
+    coordinator.population += stepped.population;
+    zmsg_destroy(&message);
+  }
+  coordinator.generation += count;
+  return !coordinator.failed;
+}
+
+// collects every shard's cells, in shard order
+auto gather(coordinator_t& coordinator, std::vector<engine::cell_t>& cells) -> bool {
+  if (coordinator.failed) return false;
+  broadcast(coordinator, "gather", nullptr);
+
+  cells.clear();
+  for (size_t index = 0; index < coordinator.controls.size(); ++index) {
+    zmsg_t* message = receive(coordinator, static_cast<int>(index), "cells");
+    if (message != nullptr && pop(message, coordinator.gathered))
+      cells.insert(std::end(cells), std::begin(coordinator.gathered), std::end(coordinator.gathered));
+    else
+      coordinator.failed = true;
+    zmsg_destroy(&message);
+  }
+  return !coordinator.failed;
+}
+
+// steps the engine's cells on the shards, reloading them whenever the cells were edited, the
+// shards run a whole step of 2^k generations before the cells are gathered back once
+auto step_engine(engine::engine_t& engine, std::vector<engine::cell_t>& cells, void* context) -> void {
+  auto& coordinator = *static_cast<coordinator_t*>(context);
+  if (!engine.synced) load(coordinator, cells, engine.generation, engine.rule, !engine.colorless);
+  if (step(coordinator, engine::step_size(engine))) gather(coordinator, cells);
+}
+
+auto attach(coordinator_t& coordinator, engine::engine_t& engine) -> void {
+  engine.remote_step = step_engine;
+  engine.remote = &coordinator;
+  engine::touch(engine);
+}
+
+}  // namespace shard::coordinator
@@ -0,0 +1,216 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+// Shard Worker Functions
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "czmq.h"
+
+#include "engine_cell.hpp"
+#include "engine_pool.hpp"
+#include "engine_rule.hpp"
+#include "engine_world.hpp"
+#include "shard.hpp"
+
+namespace shard::worker {
+
+// a worker steps its rectangle as a bounded world whose ghost cells are filled from the
+// neighbours' halos rather than left dead
+struct worker_t {
+  load_t load{};
+  engine::world::world_t world;
+  engine::pool::pool_t pool;
+
+  zsock_t* control{nullptr};
+  zsock_t* halo{nullptr};
+  std::array<zsock_t*, 8> neighbours{};
+  bool connected{false};
+  int expected{0};
+
+  // a neighbour can run at most one generation ahead, so halos are kept by the parity of their generation
+  std::array<std::array<std::vector<uint8_t>, 8>, 2> received;
+  std::array<int, 2> received_count{0, 0};
+  std::vector<uint8_t> sending;
+  std::vector<engine::cell_t> cells;
+
+  worker_t() = default;
+  worker_t(const worker_t&) = delete;
+  auto operator=(const worker_t&) -> worker_t& = delete;
+
+  ~worker_t() {
+    for (auto& neighbour : neighbours) zsock_destroy(&neighbour);
+    zsock_destroy(&halo);
+    zsock_destroy(&control);
+  }
+};
+
+// visits the buffer index of every cell along the border facing (delta_x, delta_y), or of the
+// ghost cells just beyond it
+template <typename function_t>
+auto for_each_border(const engine::world::world_t& world, const int delta_x, const int delta_y, const bool ghost, function_t&& function) -> void {
+  int begin_x = delta_x < 0 ? (ghost ? -1 : 0) : delta_x > 0 ? (ghost ? world.width : world.width - 1) : 0;
+  int end_x = delta_x == 0 ? world.width : begin_x + 1;
+  int begin_y = delta_y < 0 ? (ghost ? -1 : 0) : delta_y > 0 ? (ghost ? world.height : world.height - 1) : 0;
+  int end_y = delta_y == 0 ? world.height : begin_y + 1;
+  for (int row = begin_y; row < end_y; ++row)
+    for (int column = begin_x; column < end_x; ++column) function(engine::world::cell_index(world, column, row));
+}
+
+// the cells along the border facing (delta_x, delta_y), as many as the ghost cells beyond it
+auto border_size(const engine::world::world_t& world, const int delta_x, const int delta_y) -> size_t { return size_t(delta_x == 0 ? world.width : 1) * size_t(delta_y == 0 ? world.height : 1); }
+
+auto population(const worker_t& worker) -> uint64_t {
+  uint64_t population = 0;
+  engine::world::for_each_cell(worker.world, [&population](const int, const int) { ++population; });
+  return population;
+}
+
+// the layout never changes within a session, so the neighbours are connected on the first load
+auto connect(worker_t& worker, const std::string& base) -> void {
+  worker.connected = true;
+  for (int direction = 0; direction < 8; ++direction) {
+    const auto& [delta_x, delta_y] = engine::neighbour_deltas[direction];
+    int neighbour = shard::neighbour(worker.load.layout, worker.load.index, delta_x, delta_y);
+    if (neighbour < 0) continue;
+    worker.neighbours[direction] = zsock_new_push((">" + endpoint(base, "halo", neighbour)).c_str());
+    ++worker.expected;
+  }
+}
+
+auto load(worker_t& worker, zmsg_t* message, const std::string& base) -> bool {
+  if (!pop(message, worker.load) || !pop(message, worker.cells) || !valid(worker.load.layout)) return false;
+  if (!worker.connected) connect(worker, base);
+
+  rect_t bounds = rect(worker.load.layout, worker.load.index);
+  auto& world = worker.world;
+  world.colored = worker.load.colored;
+  world.rule = engine::rule::rule_t{worker.load.birth, worker.load.survival};
+  engine::world::resize(world, engine::world::topology_e::bounded, bounds.width, bounds.height);
+  world.origin_x = bounds.x;
+  world.origin_y = bounds.y;
+  engine::world::load(world, worker.cells);
+  return true;
+}
+
+// sends this generation's borders out and waits for the neighbours' to fill the ghost cells
+auto exchange(worker_t& worker, const uint64_t generation) -> bool {
+  auto& world = worker.world;
+  auto& cells = world.cells[world.parity];
+  auto& channels = world.channels[world.parity];
+
+  for (int direction = 0; direction < 8; ++direction) {
+    if (worker.neighbours[direction] == nullptr) continue;
+    const auto& [delta_x, delta_y] = engine::neighbour_deltas[direction];
+
+    worker.sending.resize(sizeof(halo_t));
+    for_each_border(world, delta_x, delta_y, false, [&](const size_t index) { worker.sending.push_back(cells[index]); });
+    int32_t size = static_cast<int32_t>(worker.sending.size() - sizeof(halo_t));
+    if (world.colored)
+      for (const auto& channel : channels) for_each_border(world, delta_x, delta_y, false, [&](const size_t index) { worker.sending.push_back(channel[index]); });
+
+    halo_t header{generation, direction, size};
+    std::memcpy(worker.sending.data(), &header, sizeof(header));
+    zframe_t* frame = zframe_new(worker.sending.data(), worker.sending.size());
+    if (zframe_send(&frame, worker.neighbours[direction], 0) != 0) return false;
+  }
+
+  int slot = generation & 1;
+  while (worker.received_count[slot] < worker.expected) {
+    zframe_t* frame = zframe_recv(worker.halo);
+    if (frame == nullptr) return false;
+
+    halo_t header;
+    bool valid = zframe_size(frame) >= sizeof(header);
+    if (valid) std::memcpy(&header, zframe_data(frame), sizeof(header));
+    valid = valid && header.direction >= 0 && header.direction < 8 && (header.generation == generation || header.generation == generation + 1);
+
+    // a halo has to fill exactly the ghost cells it lands in, whatever the neighbour thinks its size is
+    if (valid) {
+      const auto& [delta_x, delta_y] = engine::neighbour_deltas[header.direction];
+      size_t size = border_size(world, delta_x, delta_y);
+      valid = header.size >= 0 && static_cast<size_t>(header.size) == size && zframe_size(frame) == sizeof(header) + size * (world.colored ? 4 : 1);
+    }
+    if (valid) {
+      const auto* data = static_cast<const uint8_t*>(zframe_data(frame));
+      worker.received[header.generation & 1][header.direction].assign(data + sizeof(header), data + zframe_size(frame));
+      ++worker.received_count[header.generation & 1];
+    }
+    zframe_destroy(&frame);
+    if (!valid) return false;
+  }
+  worker.received_count[slot] = 0;
+
+  // a halo sent towards (delta_x, delta_y) lands in the ghost cells on the opposite side
+  for (int direction = 0; direction < 8; ++direction) {
+    const auto& [delta_x, delta_y] = engine::neighbour_deltas[direction];
+    if (shard::neighbour(worker.load.layout, worker.load.index, -delta_x, -delta_y) < 0) continue;
+
+    const uint8_t* data = worker.received[slot][direction].data();
+    for_each_border(world, -delta_x, -delta_y, true, [&](const size_t index) { cells[index] = *data++; });
+    if (world.colored)
+      for (auto& channel : channels) for_each_border(world, -delta_x, -delta_y, true, [&](const size_t index) { channel[index] = *data++; });
+  }
+  return true;
+}
+
+auto step(worker_t& worker, const uint64_t count) -> bool {
+  for (uint64_t generation = 0; generation < count; ++generation) {
+    if (!exchange(worker, worker.load.generation)) return false;
+    engine::rule::dispatch(worker.world.rule, [&]<engine::rule::packed_t packed>() { engine::world::step<packed>(worker.world, worker.pool); });
+    ++worker.load.generation;
+  }
+  return true;
+}
+
+// serves the coordinator until it says stop, returns the process exit code
+auto run(const std::string& base, const int index, const size_t threads) -> int {
+  worker_t worker;
+  engine::pool::resize(worker.pool, threads);
+  worker.control = zsock_new_pair((">" + endpoint(base, "control", index)).c_str());
+  worker.halo = zsock_new_pull(("@" + endpoint(base, "halo", index)).c_str());
+  if (worker.control == nullptr || worker.halo == nullptr) return 1;
+  zsock_set_rcvtimeo(worker.halo, timeout_ms);
+
+  while (true) {
+    zmsg_t* message = zmsg_recv(worker.control);
+    if (message == nullptr) return 1;
+    std::string command = pop_command(message);
+
+    bool served = true;
+    zmsg_t* reply = nullptr;
+    if (command == "load") {
+      served = load(worker, message, base);
+    } else if (command == "step") {
+      uint64_t count = 0;
+      served = pop(message, count) && step(worker, count);
+      reply = zmsg_new();
+      zmsg_addstr(reply, "stepped");
+      add(reply, stepped_t{worker.load.generation, population(worker)});
+    } else if (command == "gather") {
+      worker.cells.clear();
+      if (worker.world.colored)
+        engine::world::for_each_colored_cell(worker.world, [&](const int x, const int y, const engine::color_t& color) { worker.cells.push_back(engine::cell_t{{x, y}, color}); });
+      else
+        engine::world::for_each_cell(worker.world, [&](const int x, const int y) { worker.cells.push_back(engine::cell_t{{x, y}, engine::white}); });
+      reply = zmsg_new();
+      zmsg_addstr(reply, "cells");
+      add(reply, worker.cells);
+    } else {
+      served = command == "stop";
+    }
+    zmsg_destroy(&message);
+
+    if (reply != nullptr && served) zmsg_send(&reply, worker.control);
+    zmsg_destroy(&reply);
+    if (!served) return 1;
+    if (command == "stop") return 0;
+  }
+}
+
+}  // namespace shard::worker
@@ -0,0 +1,1414 @@
+//
+// Created by John
+// 18th of October, 2026
+//
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "fmt/format.h"
+
+#include "engine.hpp"
+#include "engine_history.hpp"
+#include "engine_index.hpp"
+#include "engine_parse.hpp"
+#include "engine_pyramid.hpp"
+#include "engine_simulation.hpp"
+
+#include "pattern.hpp"
+#include "pattern_loader.hpp"
+#include "pattern_macrocell.hpp"
+#include "pattern_rle.hpp"
+#include "pattern_snapshot.hpp"
+#include "pattern_stamp.hpp"
+
+#include "profile.hpp"
+#include "profile_allocation.hpp"
+
+#include "remote.hpp"
+#include "remote_publisher.hpp"
+#include "remote_viewer.hpp"
+
+#include "shard.hpp"
+#include "shard_coordinator.hpp"
+
+// live cells by packed coordinate
+using board_t = std::unordered_map<uint64_t, engine::color_t>;
+
+int failures = 0;
+
+auto check(const bool passed, const std::string& name) -> void {
+  if (passed) return;
+  fmt::print("FAIL {}\n", name);
+  ++failures;
+}
+
+// width x height cells around the origin, a little over a third of them live and coloured at random
+auto soup(const int width, const int height, const uint32_t seed) -> std::vector<engine::cell_t> {
+  std::mt19937 generator(seed);
+  std::vector<engine::cell_t> cells;
+  for (int y = -height / 2; y < height - height / 2; ++y) {
+    for (int x = -width / 2; x < width - width / 2; ++x) {
+      if (generator() % 100 >= 35) continue;
+      cells.push_back(engine::cell_t{{x, y}, {static_cast<uint8_t>(generator()), static_cast<uint8_t>(generator()), static_cast<uint8_t>(generator())}});
+    }
+  }
+  return cells;
+}
+
+auto board(const std::vector<engine::cell_t>& cells) -> board_t {
+  board_t live;
+  for (const auto& cell : cells) live[engine::pack_coord(cell.coord)] = cell.color;
+  return live;
+}
+
+auto sorted(std::vector<engine::cell_t> cells) -> std::vector<engine::cell_t> {
+  std::ranges::sort(cells);
+  return cells;
+}
+
+auto sorted(const board_t& live) -> std::vector<engine::cell_t> {
+  std::vector<engine::cell_t> cells;
+  for (const auto& [key, color] : live) cells.push_back(engine::cell_t{engine::unpack_coord(key), color});
+  return sorted(cells);
+}
+
+auto coords(const std::vector<engine::cell_t>& cells) -> std::vector<std::pair<int, int>> {
+  std::vector<std::pair<int, int>> coords;
+  for (const auto& cell : cells) coords.push_back(cell.coord);
+  return coords;
+}
+
+// Reference ------------------------------------
+// the update_cells the sparse engine replaced, kept as the reference for cell order
+auto reference_step(std::vector<std::pair<int, int>>& coords) -> void {
+  auto previous_coords = coords;
+  coords.clear();
+
+  std::set<std::pair<int, int>> live(previous_coords.begin(), previous_coords.end());
+  std::map<std::pair<int, int>, int> candidate_coords;
+  for (const auto& [x, y] : previous_coords) {
+    int neighbour_count = 0;
+    for (const auto& [delta_x, delta_y] : engine::neighbour_deltas) {
+      auto coord = std::make_pair(x + delta_x, y + delta_y);
+      if (live.contains(coord))
+        ++neighbour_count;
+      else
+        ++candidate_coords[coord];
+    }
+    if (neighbour_count >= 2 && neighbour_count <= 3) coords.emplace_back(x, y);
+  }
+
+  for (const auto& [coord, count] : candidate_coords)
+    if (count == 3) coords.push_back(coord);
+}
+// ----------------------------------------------
+
+// Brute Force ----------------------------------
+// neighbours beyond the edge of a finite world wrap onto a torus or are dropped by a bounded world
+const engine::world::world_t plane;
+
+// a cell's colour resolved against the board it came from: survivors keep their colour and births
+// take the mean colour of their parents
+auto resolve(const board_t& before, const std::pair<int, int>& coord, const engine::world::world_t& world = plane) -> engine::color_t {
+  if (auto found = before.find(engine::pack_coord(coord)); found != before.end()) return found->second;
+
+  engine::color_sum_t sum{0, 0, 0};
+  int count = 0;
+  for (const auto& [delta_x, delta_y] : engine::neighbour_deltas) {
+    int x = coord.first + delta_x;
+    int y = coord.second + delta_y;
+    if (!engine::world::confine(world, x, y)) continue;
+    auto parent = before.find(engine::pack_coord(x, y));
+    if (parent == before.end()) continue;
+    engine::accumulate_color(sum, parent->second);
+    ++count;
+  }
+  return engine::blend_colors(sum, count);
+}
+
+// every cell is counted by visiting the neighbourhood of every live cell, live cells are counted even
+// without neighbours for the rules that let them survive alone
+auto brute_step(const board_t& live, const engine::rule::rule_t rule = engine::rule::conway, const engine::world::world_t& world = plane) -> board_t {
+  std::unordered_map<uint64_t, int> counts;
+  for (const auto& [key, color] : live) {
+    counts.try_emplace(key, 0);
+    auto [x, y] = engine::unpack_coord(key);
+    for (const auto& [delta_x, delta_y] : engine::neighbour_deltas) {
+      int neighbour_x = x + delta_x;
+      int neighbour_y = y + delta_y;
+      if (engine::world::confine(world, neighbour_x, neighbour_y)) ++counts[engine::pack_coord(neighbour_x, neighbour_y)];
+    }
+  }
+
+  board_t next;
+  for (const auto& [key, count] : counts) {
+    if (live.contains(key) ? engine::rule::survives(rule, count) : engine::rule::born(rule, count)) next[key] = resolve(live, engine::unpack_coord(key), world);
+  }
+  return next;
+}
+
+// a jump of several generations is coloured against the board it started from
+auto brute_jump(const board_t& live, const uint64_t generations, const engine::rule::rule_t rule = engine::rule::conway, const engine::world::world_t& world = plane) -> board_t {
+  board_t next = live;
+  for (uint64_t generation = 0; generation < generations; ++generation) next = brute_step(next, rule, world);
+  for (auto& [key, color] : next) color = resolve(live, engine::unpack_coord(key), world);
+  return next;
+}
+
+// steps the engine and the brute force side by side, comparing cells and colours after every step
+auto check_engine(const std::string& name, engine::engine_t& engine, std::vector<engine::cell_t>& cells, board_t& expected, const int steps) -> bool {
+  for (int step = 0; step < steps; ++step) {
+    engine::step(engine, cells);
+    expected = brute_jump(expected, engine::step_size(engine), engine.rule, engine.world);
+    if (sorted(cells) != sorted(expected)) {
+      check(false, fmt::format("{} at generation {}", name, engine.generation));
+      return false;
+    }
+  }
+  return true;
+}
+// ----------------------------------------------
+
+// Parse ----------------------------------------
+auto test_parse() -> void {
+  int value = 7;
+  check(engine::parse_number("42", value) && value == 42, "parse number");
+  check(!engine::parse_number("42x", value) && !engine::parse_number("", value) && !engine::parse_number("99999999999", value), "parse number refuses junk");
+
+  int width = 0, height = 0;
+  check(engine::parse_size("80x60", width, height) && width == 80 && height == 60, "parse size");
+  for (const char* text : {"80", "80x", "x60", "80x60x", "80x60junk", "0x60", "80x-1", " 80x60", "80 x60"}) {
+    check(!engine::parse_size(text, width, height), fmt::format("parse size refuses {}", text));
+  }
+  check(width == 80 && height == 60, "parse size leaves the size alone on failure");
+}
+// ----------------------------------------------
+
+// Sparse ---------------------------------------
+// the same cells in the same order as the reference, coloured as the brute force colours them
+auto test_sparse() -> void {
+  engine::sparse::sparse_t sparse;
+  std::vector<engine::cell_t> cells = soup(200, 150, 1);
+  std::vector<std::pair<int, int>> expected = coords(cells);
+  board_t colored = board(cells);
+  for (int generation = 1; generation <= 100; ++generation) {
+    engine::sparse::step<engine::rule::pack(engine::rule::conway)>(sparse, cells);
+    reference_step(expected);
+    colored = brute_step(colored);
+    if (coords(cells) != expected || sorted(cells) != sorted(colored)) {
+      check(false, fmt::format("sparse at generation {}", generation));
+      return;
+    }
+  }
+}
+
+auto test_table() -> void {
+  engine::sparse::table_t<int> table;
+  std::map<uint64_t, int> expected;
+  std::mt19937 generator(2);
+  for (int insert = 0; insert < 20000; ++insert) {
+    uint64_t key = engine::pack_coord(static_cast<int>(generator() % 500) - 250, static_cast<int>(generator() % 500) - 250);
+    auto [value, inserted] = engine::sparse::insert(table, key);
+    check(inserted == !expected.contains(key), "insert reports new keys");
+    *value = insert;
+    expected[key] = insert;
+  }
+
+  bool found = table.size == expected.size();
+  for (const auto& [key, value] : expected) found = found && engine::sparse::find(table, key) && *engine::sparse::find(table, key) == value;
+  check(found, "table finds every key");
+  check(engine::sparse::find(table, engine::pack_coord(1000, 1000)) == nullptr, "table misses absent keys");
+
+  // erasing shifts back the entries that probed past the hole, so every other key is still found
+  for (int erase = 0; erase < 20000; ++erase) {
+    uint64_t key = engine::pack_coord(static_cast<int>(generator() % 500) - 250, static_cast<int>(generator() % 500) - 250);
+    check(engine::sparse::erase(table, key) == (expected.erase(key) == 1), "erase reports present keys");
+  }
+  found = table.size == expected.size();
+  for (const auto& [key, value] : expected) found = found && engine::sparse::find(table, key) && *engine::sparse::find(table, key) == value;
+  check(found, "table finds every key left after erasing");
+
+  // packed keys order the same way as the coordinates
+  check(engine::pack_coord(-1, 5) < engine::pack_coord(0, -5) && engine::pack_coord(3, -2) < engine::pack_coord(3, 1), "packed keys keep coordinate order");
+  check(engine::unpack_coord(engine::pack_coord(-2000000000, 2000000000)) == std::make_pair(-2000000000, 2000000000), "coordinates unpack");
+}
+// ----------------------------------------------
+
+// Tile -----------------------------------------
+// a soup spread over many tiles, then a glider far from it is added between steps
+auto test_tiles() -> void {
+  engine::engine_t engine;
+  engine::select(engine, engine::kind_e::tile);
+  std::vector<engine::cell_t> cells = soup(200, 150, 3);
+  board_t expected = board(cells);
+  if (!check_engine("tile", engine, cells, expected, 60)) return;
+
+  for (const auto& [x, y] : {std::pair{-1000, 1000}, std::pair{-999, 1001}, std::pair{-1001, 1002}, std::pair{-1000, 1002}, std::pair{-999, 1002}}) {
+    cells.push_back(engine::cell_t{{x, y}, {10, 20, 30}});
+    expected[engine::pack_coord(x, y)] = {10, 20, 30};
+  }
+  engine::touch(engine);
+  check_engine("tile after an edit", engine, cells, expected, 200);
+}
+
+// still lifes and oscillators straddling tile edges, with a glider passing by and waking them
+auto test_tile_skipping() -> void {
+  std::vector<std::pair<int, int>> coords{{63, 0}, {64, 0}, {65, 0}, {0, 63}, {0, 64}, {0, 65}, {-1, -1}, {0, -1}, {-1, 0}, {0, 0}, {127, 130}, {128, 129}, {128, 131}, {129, 129}, {129, 131}, {130, 130}};
+  for (const auto& [x, y] : {std::pair{1, 0}, std::pair{2, 1}, std::pair{0, 2}, std::pair{1, 2}, std::pair{2, 2}}) coords.emplace_back(x - 150, y - 100);
+
+  std::vector<engine::cell_t> cells;
+  for (const auto& [x, y] : coords) cells.push_back(engine::cell_t{{x, y}, {static_cast<uint8_t>(x), static_cast<uint8_t>(y), 7}});
+  for (const size_t threads : {1, 4}) {
+    engine::engine_t engine;
+    engine::select(engine, engine::kind_e::tile);
+    engine::set_threads(engine, threads);
+    std::vector<engine::cell_t> stepped = cells;
+    board_t expected = board(cells);
+    check_engine(fmt::format("tile skipping on {} threads", threads), engine, stepped, expected, 500);
+    check(engine.tiles.total_skipped > 0 && engine.tiles.total_woken > 0, fmt::format("tiles are skipped and woken on {} threads", threads));
+  }
+}
+
+// stepped on one thread and on several, the cells come out identical and in the same order
+auto check_threads(const std::string& name, engine::engine_t& single, engine::engine_t& parallel, std::vector<engine::cell_t> cells, const int steps) -> void {
+  engine::set_threads(single, 1);
+  engine::set_threads(parallel, 4);
+  std::vector<engine::cell_t> parallel_cells = cells;
+  for (int step = 0; step < steps; ++step) {
+    engine::step(single, cells);
+    engine::step(parallel, parallel_cells);
+    if (cells != parallel_cells) {
+      check(false, fmt::format("{} on 1 and 4 threads at generation {}", name, single.generation));
+      return;
+    }
+  }
+}
+
+auto test_tile_threads() -> void {
+  engine::engine_t single;
+  engine::engine_t parallel;
+  engine::select(single, engine::kind_e::tile);
+  engine::select(parallel, engine::kind_e::tile);
+  check_threads("tile", single, parallel, soup(400, 300, 6), 300);
+}
+// ----------------------------------------------
+
+// Pool -----------------------------------------
+// every index is visited exactly once whatever the thread count and grain
+auto test_pool() -> void {
+  engine::pool::pool_t pool;
+  for (const size_t threads : {1, 2, 3, 8}) {
+    engine::pool::resize(pool, threads);
+    for (const size_t grain : {1, 4, 64}) {
+      std::vector<std::atomic<int>> visits(10007);
+      engine::pool::parallel_for(pool, visits.size(), [&visits](const size_t index) { ++visits[index]; }, grain);
+      check(std::ranges::all_of(visits, [](const auto& count) { return count == 1; }), fmt::format("parallel_for on {} threads with grain {}", threads, grain));
+    }
+  }
+}
+// ----------------------------------------------
+
+// HashLife -------------------------------------
+// single generations and jumps of 2^k, changing the exponent part way through
+auto test_hashlife() -> void {
+  for (const int exponent : {0, 3, 6}) {
+    engine::engine_t engine;
+    engine::select(engine, engine::kind_e::hashlife);
+    engine::set_step_exponent(engine, exponent);
+    std::vector<engine::cell_t> cells = soup(160, 120, 4);
+    board_t expected = board(cells);
+    if (!check_engine(fmt::format("hashlife 2^{}", exponent), engine, cells, expected, 128 >> exponent)) continue;
+
+    engine::set_step_exponent(engine, exponent + 1);
+    check_engine(fmt::format("hashlife 2^{} after 2^{}", exponent + 1, exponent), engine, cells, expected, 4);
+  }
+}
+
+// a store capped below what the soup needs still steps it correctly, collecting as it goes
+auto test_hashlife_memory() -> void {
+  engine::engine_t engine;
+  engine::select(engine, engine::kind_e::hashlife);
+  engine::set_step_exponent(engine, 4);
+  engine.hashlife.memory_limit = size_t{256} << 10;
+  std::vector<engine::cell_t> cells = soup(160, 120, 5);
+  board_t expected = board(cells);
+  check_engine("hashlife under a memory cap", engine, cells, expected, 8);
+  check(engine.hashlife.collections > 0, "hashlife collects under a memory cap");
+
+  // a jump too large for the store is retried in smaller jumps without growing past the limit
+  engine::engine_t capped;
+  engine::select(capped, engine::kind_e::hashlife);
+  engine::set_step_exponent(capped, 8);
+  capped.hashlife.memory_limit = size_t{256} << 10;
+  cells = soup(64, 48, 6);
+  expected = board(cells);
+  check_engine("hashlife jumps under a memory cap", capped, cells, expected, 3);
+  check(capped.hashlife.collections > 0, "hashlife collects within a jump");
+  check(capped.hashlife.nodes.capacity() == capped.hashlife.max_nodes, "hashlife store stays within its reservation");
+  check(engine::hashlife::memory_usage(capped.hashlife) <= capped.hashlife.memory_limit, "hashlife memory usage under the cap");
+  size_t reserved = capped.hashlife.table.capacity() * sizeof(uint32_t) + capped.hashlife.max_nodes * (sizeof(engine::hashlife::node_t) + sizeof(uint32_t));
+  check(reserved <= capped.hashlife.memory_limit, "hashlife reservations sum to the cap");
+}
+// ----------------------------------------------
+
+// Colours --------------------------------------
+// every engine colours births the same way whatever order the cells arrive in, or not at all
+auto test_colors() -> void {
+  std::vector<engine::cell_t> cells = soup(200, 150, 17);
+  std::vector<engine::cell_t> shuffled = cells;
+  std::ranges::shuffle(shuffled, std::mt19937(18));
+
+  std::vector<std::vector<engine::cell_t>> results;
+  for (const auto kind : {engine::kind_e::sparse, engine::kind_e::tile, engine::kind_e::hashlife}) {
+    for (const auto& start : {cells, shuffled}) {
+      engine::engine_t engine;
+      engine::select(engine, kind);
+      std::vector<engine::cell_t> stepped = start;
+      for (int step = 0; step < 30; ++step) engine::step(engine, stepped);
+      results.push_back(sorted(stepped));
+    }
+
+    engine::engine_t colorless;
+    engine::select(colorless, kind);
+    engine::set_colorless(colorless, true);
+    std::vector<engine::cell_t> stepped = cells;
+    for (int step = 0; step < 30; ++step) engine::step(colorless, stepped);
+    bool white = std::ranges::all_of(stepped, [](const engine::cell_t& cell) { return cell.color == engine::white; });
+    check(white && coords(sorted(stepped)) == coords(results.back()), fmt::format("{} without colour", engine::kind_name(kind)));
+  }
+  check(std::ranges::all_of(results, [&results](const auto& result) { return result == results.front(); }), "engines agree on colours in any order");
+}
+// ----------------------------------------------
+
+// Rules ----------------------------------------
+// every common rule and one that only runs the generic kernels, on every engine
+auto test_rules() -> void {
+  std::vector<engine::rule::rule_t> rules(engine::rule::common.begin(), engine::rule::common.end());
+  rules.push_back(engine::rule::rule_t{engine::rule::mask({3, 5}), engine::rule::mask({2, 3, 6})});
+
+  for (const auto rule : rules) {
+    for (const auto kind : {engine::kind_e::sparse, engine::kind_e::tile, engine::kind_e::hashlife}) {
+      engine::engine_t engine;
+      engine::select(engine, kind);
+      engine::set_rule(engine, rule);
+      std::vector<engine::cell_t> cells = soup(100, 80, 21);
+      board_t expected = board(cells);
+      check_engine(fmt::format("{} {}", engine::kind_name(kind), engine::rule::format(rule)), engine, cells, expected, 30);
+    }
+  }
+
+  // hashlife jumps under a rule other than life
+  engine::engine_t engine;
+  engine::select(engine, engine::kind_e::hashlife);
+  engine::set_rule(engine, engine::rule::common[1]);
+  engine::set_step_exponent(engine, 3);
+  std::vector<engine::cell_t> cells = soup(100, 80, 22);
+  board_t expected = board(cells);
+  check_engine("hashlife 2^3 highlife", engine, cells, expected, 8);
+}
+
+auto test_rulestrings() -> void {
+  engine::rule::rule_t rule;
+  check(engine::rule::parse("B36/S23", rule) && rule == engine::rule::common[1] && engine::rule::format(rule) == "B36/S23", "highlife round trips");
+  check(engine::rule::parse("s23/b3", rule) && rule == engine::rule::conway, "either half first in either case");
+  check(engine::rule::parse("B2/S", rule) && rule == engine::rule::common[3], "an empty half");
+  for (const auto& text : {"B03/S23", "B3/S29", "B3", "S23", "B3/S23/B3", "B3/Q23", ""}) check(!engine::rule::parse(text, rule), fmt::format("{} is refused", text));
+
+  rule = engine::rule::conway;
+  for (size_t index = 0; index < engine::rule::common.size(); ++index) rule = engine::rule::next_common(rule);
+  check(rule == engine::rule::conway, "cycling the common rules comes back round");
+
+  // a B/S rulestring keeps the engine unless it is the ltl one, a larger than life one selects it
+  engine::engine_t engine;
+  engine::select(engine, engine::kind_e::tile);
+  check(engine::set_rulestring(engine, "B36/S23") && engine.kind == engine::kind_e::tile && engine.rule == engine::rule::common[1], "a B/S rulestring keeps the engine");
+  check(engine::set_rulestring(engine, "R2,C0,M1,S6..10,B6..8,NM") && engine.kind == engine::kind_e::ltl, "a larger than life rulestring selects the ltl engine");
+  check(engine::set_rulestring(engine, "B3/S23") && engine.kind == engine::kind_e::sparse && engine.rule == engine::rule::conway, "a B/S rulestring leaves the ltl engine");
+  check(!engine::set_rulestring(engine, "B3/Q23") && engine.kind == engine::kind_e::sparse, "an unknown rulestring changes nothing");
+  engine::set_world(engine, engine::world::topology_e::torus, 100, 80);
+  check(!engine::set_rulestring(engine, "R2,C0,M1,S6..10,B6..8,NM") && engine.kind == engine::kind_e::sparse, "a finite world refuses a larger than life rulestring");
+  check(engine::set_rulestring(engine, "B36/S23") && engine.rule == engine::rule::common[1], "a finite world takes a B/S rulestring");
+
+  // queued rulestrings are taken in order with the edits around them
+  engine::simulation::simulation_t simulation;
+  engine::simulation::queue_rulestring(simulation, "R2,C0,M1,S6..10,B6..8,NM");
+  engine::simulation::queue(simulation, engine::simulation::edit_t{engine::simulation::edit_e::select, static_cast<int>(engine::kind_e::tile), 0, {}});
+  engine::simulation::queue_rulestring(simulation, "B36/S23");
+  std::swap(simulation.edits, simulation.applying);
+  engine::simulation::apply(simulation);
+  check(simulation.engine.kind == engine::kind_e::tile && simulation.engine.rule == engine::rule::common[1] && simulation.rulestrings.empty(), "queued rulestrings apply in order");
+}
+// ----------------------------------------------
+
+// Worlds ---------------------------------------
+// both finite topologies under two rules, with sizes that are not whole tiles or bands, the world
+// stepping in place of whichever engine is selected
+auto test_worlds() -> void {
+  for (const auto topology : {engine::world::topology_e::torus, engine::world::topology_e::bounded}) {
+    for (const auto rule : {engine::rule::conway, engine::rule::common[1]}) {
+      for (const auto kind : {engine::kind_e::sparse, engine::kind_e::hashlife}) {
+        engine::engine_t engine;
+        engine::select(engine, kind);
+        engine::set_rule(engine, rule);
+        engine::set_step_exponent(engine, 4);
+        engine::set_world(engine, topology, 150, 110);
+        std::vector<engine::cell_t> cells = soup(150, 110, 25);
+        board_t expected = board(cells);
+        check_engine(fmt::format("{} world {} under {}", engine::world::topology_name(topology), engine::rule::format(rule), engine::kind_name(kind)), engine, cells, expected, 60);
+      }
+
+      engine::engine_t single;
+      engine::engine_t parallel;
+      for (auto* threaded : {&single, &parallel}) {
+        engine::set_rule(*threaded, rule);
+        engine::set_world(*threaded, topology, 301, 203);
+      }
+      check_threads(fmt::format("{} world {}", engine::world::topology_name(topology), engine::rule::format(rule)), single, parallel, soup(301, 203, 26), 60);
+    }
+  }
+
+  // cells outside the world wrap onto a torus and are dropped by a bounded world
+  for (const auto topology : {engine::world::topology_e::torus, engine::world::topology_e::bounded}) {
+    engine::engine_t outside;
+    engine::engine_t inside;
+    engine::set_world(outside, topology, 100, 80);
+    engine::set_world(inside, topology, 100, 80);
+    std::vector<engine::cell_t> cells = soup(300, 200, 27);
+    board_t expected;
+    for (auto cell : cells) {
+      if (engine::world::confine(inside.world, cell.coord.first, cell.coord.second)) expected[engine::pack_coord(cell.coord)] = cell.color;
+    }
+    std::vector<engine::cell_t> confined;
+    for (const auto& [key, color] : expected) confined.push_back(engine::cell_t{engine::unpack_coord(key), color});
+    engine::step(outside, cells);
+    engine::step(inside, confined);
+    check(sorted(cells) == sorted(confined), fmt::format("cells are confined to a {} world", engine::world::topology_name(topology)));
+  }
+}
+// ----------------------------------------------
+
+// Larger than Life -----------------------------
+// counts every live cell within the rule's neighbourhood, births take the truncated mean colour of the
+// live cells they counted and survivors keep theirs
+auto brute_ltl_step(const board_t& live, const engine::ltl::rule_t& rule) -> board_t {
+  std::unordered_map<uint64_t, std::pair<int, engine::color_sum_t>> counts;
+  for (const auto& [key, color] : live) {
+    counts.try_emplace(key, 0, engine::color_sum_t{0, 0, 0});
+    auto [x, y] = engine::unpack_coord(key);
+    for (int delta_y = -rule.radius; delta_y <= rule.radius; ++delta_y) {
+      for (int delta_x = -rule.radius; delta_x <= rule.radius; ++delta_x) {
+        if (rule.neighbourhood == engine::ltl::neighbourhood_e::von_neumann && std::abs(delta_x) + std::abs(delta_y) > rule.radius) continue;
+        if (delta_x == 0 && delta_y == 0 && !rule.middle) continue;
+        auto& [count, sum] = counts[engine::pack_coord(x + delta_x, y + delta_y)];
+        ++count;
+        for (int channel = 0; channel < 3; ++channel) sum[channel] += color[channel];
+      }
+    }
+  }
+
+  board_t next;
+  for (const auto& [key, counted] : counts) {
+    const auto& [count, sum] = counted;
+    auto found = live.find(key);
+    if (found != live.end() && count >= rule.survival_min && count <= rule.survival_max)
+      next[key] = found->second;
+    else if (found == live.end() && count >= rule.birth_min && count <= rule.birth_max)
+      next[key] = engine::color_t{static_cast<uint8_t>(sum[0] / count), static_cast<uint8_t>(sum[1] / count), static_cast<uint8_t>(sum[2] / count)};
+  }
+  return next;
+}
+
+auto test_ltl() -> void {
+  for (const auto& text : {"R2,C0,M0,S3..6,B4..5,NM", "R3,C0,M1,S5..12,B6..9,NN", "R5,C0,M1,S34..58,B34..45,NM"}) {
+    engine::ltl::rule_t rule;
+    if (!engine::ltl::parse(text, rule)) {
+      check(false, fmt::format("{} parses", text));
+      continue;
+    }
+    check(engine::ltl::format(rule) == text, fmt::format("{} round trips", text));
+
+    engine::engine_t engine;
+    engine::select(engine, engine::kind_e::ltl);
+    engine::set_ltl_rule(engine, rule);
+    std::vector<engine::cell_t> cells = soup(160, 120, 23);
+    board_t expected = board(cells);
+    for (int step = 0; step < 15; ++step) {
+      engine::step(engine, cells);
+      expected = brute_ltl_step(expected, rule);
+      if (sorted(cells) != sorted(expected)) {
+        check(false, fmt::format("{} at generation {}", text, engine.generation));
+        break;
+      }
+    }
+
+    engine::engine_t single;
+    engine::engine_t parallel;
+    for (auto* threaded : {&single, &parallel}) {
+      engine::select(*threaded, engine::kind_e::ltl);
+      engine::set_ltl_rule(*threaded, rule);
+    }
+    check_threads(text, single, parallel, soup(300, 200, 24), 15);
+  }
+
+  engine::ltl::rule_t rule;
+  for (const auto& text : {"R0,C0,M0,S1..2,B1..2,NM", "R17,C0,M0,S1..2,B1..2,NM", "R2,C3,M0,S1..2,B1..2,NM", "R2,C0,M0,S1..2,B0..2,NM", "R2,C0,M0,S1..2,NM", "R2,C0,M0,S1..x,B1..2,NM", "R2,C0,M0,S1..2,B1..2,NX"})
+    check(!engine::ltl::parse(text, rule), fmt::format("{} is refused", text));
+}
+// ----------------------------------------------
+
+// Shards ---------------------------------------
+// every coord of the world is owned by the shard whose rectangle holds it
+auto test_layout() -> void {
+  for (const auto& [columns, rows] : {std::pair{1, 1}, {3, 2}, {7, 5}}) {
+    shard::layout_t layout{engine::world::topology_e::torus, 151, 111, columns, rows};
+    bool owned = true;
+    for (int y = -(layout.height / 2); y < layout.height - layout.height / 2; ++y) {
+      for (int x = -(layout.width / 2); x < layout.width - layout.width / 2; ++x) {
+        shard::rect_t rect = shard::rect(layout, shard::owner(layout, x, y));
+        owned = owned && x >= rect.x && x < rect.x + rect.width && y >= rect.y && y < rect.y + rect.height;
+      }
+    }
+    check(owned, fmt::format("{}x{} shards own the whole world", columns, rows));
+  }
+
+  // every shard is at least one cell wide and high
+  const auto torus = engine::world::topology_e::torus;
+  check(shard::valid(shard::layout_t{torus, 6, 40, 6, 1}) && shard::valid(shard::layout_t{torus, 40, 6, 1, 6}), "shards one cell across fit");
+  check(!shard::valid(shard::layout_t{torus, 6, 40, 7, 1}) && !shard::valid(shard::layout_t{torus, 40, 6, 1, 7}) && !shard::valid(shard::layout_t{torus, 40, 40, 0, 1}), "shards wider than the world are refused");
+}
+
+// threaded workers trading halos step both topologies as the brute force does, colours included,
+// down to shards a single cell wide
+auto test_shards() -> void {
+  int session = 0;
+  for (const auto topology : {engine::world::topology_e::torus, engine::world::topology_e::bounded}) {
+    for (const auto& [width, columns, rows] : {std::tuple{150, 1, 1}, {150, 2, 2}, {150, 3, 2}, {4, 4, 1}}) {
+      shard::layout_t layout{topology, width, 110, columns, rows};
+      engine::engine_t engine;
+      engine::set_world(engine, topology, layout.width, layout.height);
+
+      shard::coordinator::coordinator_t coordinator;
+      std::string name = fmt::format("{} world on {}x{} shards", engine::world::topology_name(topology), columns, rows);
+      if (!shard::coordinator::start(coordinator, fmt::format("inproc://life_test_shards_{}", session++), layout, columns)) {
+        check(false, name + " start");
+        continue;
+      }
+      shard::coordinator::attach(coordinator, engine);
+      std::vector<engine::cell_t> cells = soup(width, 110, 32);
+      board_t expected = board(cells);
+      check_engine(name, engine, cells, expected, 20);
+
+      // a step of 2^k generations runs on the workers, which colour every generation as they go
+      engine::set_step_exponent(engine, 3);
+      for (int step = 0; step < 5; ++step) {
+        engine::step(engine, cells);
+        for (uint64_t generation = 0; generation < engine::step_size(engine); ++generation) expected = brute_step(expected, engine.rule, engine.world);
+      }
+      check(engine.generation == 60 && sorted(cells) == sorted(expected), name + " in steps of 8 generations");
+      check(!coordinator.failed, name + " answers every step");
+    }
+  }
+}
+// ----------------------------------------------
+
+// Index ----------------------------------------
+// rectangles of every size, including ones reaching the limits of int, against a plain filter,
+// rebuilding the index as the soup is stepped
+auto test_index() -> void {
+  engine::engine_t engine;
+  engine::index::index_t index;
+  std::vector<engine::cell_t> cells = soup(400, 300, 12);
+  std::mt19937 generator(13);
+  for (int round = 0; round < 20; ++round) {
+    uint64_t revision = engine.revision;
+    engine::step(engine, cells);
+    check(engine.revision != revision, "a step bumps the revision");
+    engine::index::build(index, cells, engine.revision);
+
+    for (int query = 0; query < 50; ++query) {
+      int min_x = static_cast<int>(generator() % 500) - 250;
+      int min_y = static_cast<int>(generator() % 400) - 200;
+      int max_x = min_x + static_cast<int>(generator() % (query < 40 ? 40 : 400));
+      int max_y = min_y + static_cast<int>(generator() % (query < 40 ? 40 : 400));
+      if (query == 49) {
+        min_x = min_y = std::numeric_limits<int>::min();
+        max_x = max_y = std::numeric_limits<int>::max();
+      }
+
+      std::vector<engine::cell_t> found;
+      engine::index::query(index, cells, min_x, min_y, max_x, max_y, [&found](const engine::cell_t& cell) { found.push_back(cell); });
+      std::vector<engine::cell_t> expected;
+      for (const auto& cell : cells)
+        if (cell.coord.first >= min_x && cell.coord.first <= max_x && cell.coord.second >= min_y && cell.coord.second <= max_y) expected.push_back(cell);
+      if (sorted(found) != sorted(expected)) {
+        check(false, fmt::format("index query {} {} {} {} in round {}", min_x, min_y, max_x, max_y, round));
+        return;
+      }
+    }
+
+    board_t live = board(cells);
+    bool contained = true;
+    for (int probe = 0; probe < 200; ++probe) {
+      int x = static_cast<int>(generator() % 500) - 250;
+      int y = static_cast<int>(generator() % 400) - 200;
+      contained = contained && engine::index::contains(index, cells, x, y) == live.contains(engine::pack_coord(x, y));
+    }
+    check(contained, fmt::format("index contains the live cells in round {}", round));
+
+    bool summed = true;
+    for (const auto& chunk : index.chunks) {
+      std::array<uint64_t, 3> color_sum{0, 0, 0};
+      for (uint32_t position = chunk.begin; position < chunk.end; ++position)
+        for (int channel = 0; channel < 3; ++channel) color_sum[channel] += cells[index.order[position]].color[channel];
+      summed = summed && chunk.color_sum == color_sum;
+    }
+    check(summed, fmt::format("index chunks sum their colours in round {}", round));
+  }
+
+  uint64_t revision = engine.revision;
+  engine::touch(engine);
+  check(engine.revision != revision, "an edit bumps the revision");
+}
+
+// every block of every level over rectangles in view against counts and colour sums taken
+// straight from the cells, rebuilt when the revision or the rectangle moves on
+auto test_pyramid() -> void {
+  engine::engine_t engine;
+  engine::index::index_t index;
+  engine::pyramid::pyramid_t pyramid;
+  std::vector<engine::cell_t> cells = soup(400, 300, 14);
+  std::mt19937 generator(34);
+  for (int round = 0; round < 3; ++round) {
+    engine::index::build(index, cells, engine.revision);
+    for (const int k : {1, 2, 5, 3, 9, 6}) {
+      for (int view = 0; view < 4; ++view) {
+        int min_x = static_cast<int>(generator() % 400) - 250;
+        int min_y = static_cast<int>(generator() % 300) - 200;
+        int max_x = min_x + static_cast<int>(generator() % 300);
+        int max_y = min_y + static_cast<int>(generator() % 300);
+        if (view == 3) {
+          min_x = min_y = std::numeric_limits<int>::min();
+          max_x = max_y = std::numeric_limits<int>::max();
+        }
+
+        // the view widens out to whole blocks, and to whole chunks below the chunk size
+        auto [block_min_x, block_min_y, block_max_x, block_max_y] = engine::pyramid::block_rect(std::max(k, engine::index::chunk_shift), min_x, min_y, max_x, max_y);
+        std::map<std::pair<int, int>, engine::pyramid::block_t> expected;
+        for (const auto& cell : cells) {
+          const auto& [x, y] = cell.coord;
+          if (x < block_min_x || x > block_max_x || y < block_min_y || y > block_max_y) continue;
+          auto& block = expected[{x >> k, y >> k}];
+          block.count += 1;
+          for (int channel = 0; channel < 3; ++channel) block.color_sum[channel] += cell.color[channel];
+        }
+
+        auto& level = engine::pyramid::level(pyramid, index, cells, engine.revision, k, min_x, min_y, max_x, max_y);
+        bool matches = level.blocks.size() == expected.size();
+        for (const auto& [coord, block] : expected) {
+          const auto* found = engine::pyramid::find(level, coord.first, coord.second);
+          matches = matches && found != nullptr && found->count == block.count && found->color_sum == block.color_sum;
+        }
+        check(matches, fmt::format("pyramid level {} over {} {} {} {} in round {}", k, min_x, min_y, max_x, max_y, round));
+      }
+    }
+    for (int step = 0; step < 10; ++step) engine::step(engine, cells);
+  }
+}
+// ----------------------------------------------
+
+// Simulation -----------------------------------
+// random runs of cell edits in their own colours against a plain board, with steps, clears and
+// other edits in between, so a cell moved into a removed one's place keeps its colour and the
+// positions kept from one run to the next stay right
+auto test_edits() -> void {
+  engine::simulation::simulation_t simulation;
+  board_t expected;
+  std::mt19937 generator(15);
+  for (int round = 0; round < 200; ++round) {
+    int edits = static_cast<int>(generator() % (round % 2 == 0 ? 20 : 2000));
+    for (int edit = 0; edit < edits; ++edit) {
+      int x = static_cast<int>(generator() % 40) - 20;
+      int y = static_cast<int>(generator() % 40) - 20;
+      engine::color_t color{static_cast<uint8_t>(generator()), static_cast<uint8_t>(generator()), static_cast<uint8_t>(generator())};
+      uint64_t key = engine::pack_coord(x, y);
+      auto kind = static_cast<engine::simulation::edit_e>(generator() % 3);
+      if (generator() % 10 == 0 && !expected.contains(key)) kind = engine::simulation::edit_e::append;
+      simulation.applying.push_back(engine::simulation::edit_t{kind, x, y, color});
+
+      bool alive = expected.contains(key);
+      if (kind == engine::simulation::edit_e::remove || (kind == engine::simulation::edit_e::toggle && alive))
+        expected.erase(key);
+      else if (!alive)
+        expected[key] = color;
+    }
+    if (round % 7 == 2) simulation.applying.push_back(engine::simulation::edit_t{engine::simulation::edit_e::select, static_cast<int>(engine::kind_e::sparse), 0, {}});
+    if (round % 17 == 0) {
+      simulation.applying.push_back(engine::simulation::edit_t{engine::simulation::edit_e::clear, 0, 0, {}});
+      expected.clear();
+    }
+    if (round % 5 == 3) {
+      simulation.applying.push_back(engine::simulation::edit_t{engine::simulation::edit_e::step, 0, 0, {}});
+      expected = brute_step(expected);
+    }
+    engine::simulation::apply(simulation);
+    if (sorted(simulation.cells) != sorted(expected)) {
+      check(false, fmt::format("cell edits in round {}", round));
+      return;
+    }
+  }
+}
+
+// waits for the simulation thread to publish a snapshot at generation
+auto await_generation(engine::simulation::simulation_t& simulation, const uint64_t generation) -> const engine::simulation::snapshot_t* {
+  auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (std::chrono::steady_clock::now() < give_up) {
+    const auto& snapshot = engine::simulation::latest(simulation);
+    if (snapshot.stats.generation == generation) return &snapshot;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return nullptr;
+}
+
+// the thread steps queued edits and runs while updating, its snapshots match the brute force and
+// each one calls the listener
+auto test_simulation() -> void {
+  engine::simulation::simulation_t simulation;
+  engine::select(simulation.engine, engine::kind_e::tile);
+  std::atomic<int> published{0};
+  simulation.published = [](void* context) { static_cast<std::atomic<int>*>(context)->fetch_add(1); };
+  simulation.listener = &published;
+  engine::simulation::start(simulation);
+
+  std::vector<engine::cell_t> cells = soup(200, 150, 16);
+  board_t expected = board(cells);
+  std::vector<engine::simulation::edit_t> edits;
+  for (const auto& cell : cells) edits.push_back(engine::simulation::edit_t{engine::simulation::edit_e::append, cell.coord.first, cell.coord.second, cell.color});
+  for (int step = 0; step < 10; ++step) edits.push_back(engine::simulation::edit_t{engine::simulation::edit_e::step, 0, 0, {}});
+  engine::simulation::queue(simulation, edits);
+  for (int step = 0; step < 10; ++step) expected = brute_step(expected);
+
+  const auto* snapshot = await_generation(simulation, 10);
+  check(snapshot != nullptr && sorted(snapshot->cells) == sorted(expected), "simulation applies queued edits and steps");
+  check(published > 0 && !engine::simulation::fresh_snapshot(simulation), "simulation wakes its reader on publishing");
+
+  // run at a modest rate until paused, then catch the brute force up with wherever it stopped
+  engine::simulation::set_rate(simulation, 200.0);
+  engine::simulation::set_updating(simulation, true);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  engine::simulation::set_updating(simulation, false);
+  engine::simulation::queue(simulation, engine::simulation::edit_t{engine::simulation::edit_e::step, 0, 0, {}});
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  snapshot = &engine::simulation::latest(simulation);
+  uint64_t generation = snapshot->stats.generation;
+  for (uint64_t step = 10; step < generation; ++step) expected = brute_step(expected);
+  check(generation > 11 && generation < 100 && sorted(snapshot->cells) == sorted(expected), "simulation runs at its rate while updating");
+}
+// ----------------------------------------------
+
+// Pattern --------------------------------------
+auto test_plaintext() -> void {
+  auto coords = pattern::parse_plaintext("!Name: glider\n!\n.O.\n..*\nOOO\n");
+  check(coords == pattern::coords_t{{1, 0}, {2, 1}, {0, 2}, {1, 2}, {2, 2}}, "plaintext glider");
+  check(pattern::parse_plaintext("").empty() && pattern::parse_plaintext("...\n...").empty(), "plaintext without live cells");
+}
+
+auto test_soup() -> void {
+  auto coords = pattern::soup(160, 120, 0.25, 7);
+  check(coords == pattern::soup(160, 120, 0.25, 7) && coords != pattern::soup(160, 120, 0.25, 8), "soups are seeded");
+  check(std::ranges::all_of(coords, [](const auto& coord) { return coord.first >= -80 && coord.first < 80 && coord.second >= -60 && coord.second < 60; }), "soups are centred");
+  check(coords.size() > 4200 && coords.size() < 5400, "soups have their density");
+}
+
+// the r-pentomino settles at generation 1103 with 116 cells, six of them in escaping gliders
+auto test_rpentomino() -> void {
+  engine::engine_t engine;
+  std::vector<engine::cell_t> cells;
+  for (const auto& coord : pattern::rpentomino(0, 0)) cells.push_back(engine::cell_t{coord, engine::color_t{255, 255, 255}});
+  while (engine.generation < 1103) engine::step(engine, cells);
+  check(cells.size() == 116, "r-pentomino settles with 116 cells");
+}
+
+// the canonical bench workloads behave as documented: the acorn settles at generation 5206 with 633
+// cells, and the gun adds a five cell glider every 30 generations
+auto test_canonical() -> void {
+  auto load = [](const pattern::coords_t& coords) {
+    std::vector<engine::cell_t> cells;
+    for (const auto& coord : coords) cells.push_back(engine::cell_t{coord, engine::color_t{255, 255, 255}});
+    return cells;
+  };
+
+  engine::engine_t engine;
+  engine::select(engine, engine::kind_e::tile);
+  std::vector<engine::cell_t> cells = load(pattern::acorn());
+  while (engine.generation < 5206) engine::step(engine, cells);
+  check(cells.size() == 633, "acorn settles with 633 cells");
+
+  engine::engine_t gun;
+  cells = load(pattern::gosper_glider_gun());
+  std::vector<size_t> populations;
+  while (gun.generation < 300) {
+    engine::step(gun, cells);
+    if (gun.generation % 30 == 0) populations.push_back(cells.size());
+  }
+  bool growing = true;
+  for (size_t period = 1; period < populations.size(); ++period) growing = growing && populations[period] == populations[period - 1] + 5;
+  check(growing, "gosper glider gun adds a glider every period");
+
+  // doubling the generation about quadruples the filled area
+  engine::engine_t max;
+  engine::select(max, engine::kind_e::hashlife);
+  engine::set_step_exponent(max, 6);
+  cells = load(pattern::max_spacefiller());
+  check(cells.size() == 187, "max spacefiller has 187 cells");
+  std::vector<size_t> filled;
+  while (max.generation < 1024) {
+    engine::step(max, cells);
+    if (max.generation == 256 || max.generation == 512 || max.generation == 1024) filled.push_back(cells.size());
+  }
+  check(filled.size() == 3 && filled[1] > filled[0] * 3.5 && filled[1] < filled[0] * 4.5 && filled[2] > filled[1] * 3.5 && filled[2] < filled[1] * 4.5, "max spacefiller grows quadratically");
+}
+// ----------------------------------------------
+
+// Pattern Files --------------------------------
+using coord_set_t = std::set<std::pair<int, int>>;
+
+auto temporary_path(const std::string& extension) -> std::string {
+  return (std::filesystem::temp_directory_path() / fmt::format("life_test_{}.{}", std::chrono::steady_clock::now().time_since_epoch().count(), extension)).string();
+}
+
+// calls write(file) on a temporary file and returns what it wrote
+template <typename function_t>
+auto written(function_t&& write) -> std::string {
+  std::FILE* file = std::tmpfile();
+  write(file);
+  std::string text(static_cast<size_t>(std::ftell(file)), '\0');
+  std::rewind(file);
+  text.resize(std::fread(text.data(), 1, text.size(), file));
+  std::fclose(file);
+  return text;
+}
+
+// a soup far from the origin, so offsets and negative coordinates are written too
+auto file_soup(const uint32_t seed) -> coord_set_t {
+  coord_set_t coords;
+  for (const auto& [x, y] : pattern::soup(300, 200, 0.3, seed)) coords.insert({x - 100000, y + 70000});
+  return coords;
+}
+
+auto test_rle() -> void {
+  coord_set_t parsed;
+  auto collect = [&parsed](const int x, const int y) { parsed.insert({x, y}); };
+  check(pattern::rle::parse("#N glider\nx = 3, y = 3, rule = B3/S23\nbo$2bo$3o!\n", collect) && parsed == coord_set_t{{1, 0}, {2, 1}, {0, 2}, {1, 2}, {2, 2}}, "rle glider");
+  check(!pattern::rle::parse("bo$2bo$3o!\n", collect), "rle without a header is refused");
+
+  coord_set_t coords = file_soup(9);
+  std::string text = written([&coords](std::FILE* file) { pattern::rle::write(file, std::vector(coords.begin(), coords.end())); });
+  parsed.clear();
+  check(pattern::rle::parse(text, collect) && parsed == coords, "rle write and parse round trip");
+
+  // the rule runs to the end of the header line, larger than life rules hold commas of their own
+  check(pattern::rle::header_rule(text) == "B3/S23", "rle writes its rule");
+  check(pattern::rle::header_rule("#C comment\nx = 3, y = 3, rule = R2,C0,M1,S6..10,B6..8,NM\r\n3o!\n") == "R2,C0,M1,S6..10,B6..8,NM", "rle reads a larger than life rule");
+  check(pattern::rle::header_rule("x = 3, y = 3\nrule\n").empty() && pattern::rle::header_rule("bo$2bo$3o!\n").empty(), "rle without a rule has none");
+
+  int runs = 0;
+  auto count = [&runs](const int, const int) { ++runs; };
+  check(!pattern::rle::parse("x = 1, y = 1\n99999999999o!\n", count) && !pattern::rle::parse("x = 1, y = 1\n2147483647b2o!\n", count), "rle refuses runs that overflow");
+  check(!pattern::rle::parse("#R 0 10\nx = 1, y = 1\n2147483640$o!\n", count), "rle refuses rows that overflow");
+  check(runs == 0, "rle emits no cells past the range of int");
+}
+
+auto test_macrocell() -> void {
+  coord_set_t coords = file_soup(10);
+  std::vector<engine::cell_t> cells;
+  for (const auto& coord : coords) cells.push_back(engine::cell_t{coord, engine::color_t{255, 255, 255}});
+  engine::hashlife::hashlife_t hashlife;
+  engine::hashlife::load(hashlife, cells);
+
+  std::string text = written([&hashlife](std::FILE* file) { pattern::macrocell::write(file, hashlife, "R2,C0,M1,S6..10,B6..8,NM", 42); });
+  coord_set_t parsed;
+  auto collect = [&parsed](const int x, const int y) { parsed.insert({x, y}); };
+  check(pattern::macrocell::parse(text, collect) && parsed == coords, "macrocell write and parse round trip");
+  check(pattern::macrocell::header_rule(text) == "R2,C0,M1,S6..10,B6..8,NM", "macrocell keeps the rule it was written with");
+  check(pattern::macrocell::header_rule("[M2] (life)\n#R B36/S23 \r\n#G 5\n") == "B36/S23" && pattern::macrocell::header_rule("[M2] (life)\n1 0 0 0 0\n#R B36/S23\n").empty(), "macrocell rule comes from the header only");
+  check(!pattern::macrocell::parse("[M2] (life)\n4 1 0 0 0\n", collect), "macrocell with a missing child is refused");
+  check(!pattern::macrocell::parse("[M2] (life)\n$*$\n300 1 0 0 0\n", collect) && !pattern::macrocell::parse("[M2] (life)\n$*$\n64 0 0 0 0\n", collect), "macrocell refuses levels past 63");
+  check(!pattern::macrocell::parse("[M2] (life)\n$*$\n5 1 0 0 0\n", collect), "macrocell refuses a leaf below level 4");
+  check(!pattern::macrocell::parse("[M2] (life)\n$*$\n4 1 0 0 0\n6 2 0 0 0\n", collect), "macrocell refuses children more than a level below");
+  parsed.clear();
+  check(pattern::macrocell::parse("[M2] (life)\n$*$\n4 1 0 0 0\n5 0 0 0 2\n", collect) && parsed.size() == 1, "macrocell accepts children a level below");
+  check(!pattern::macrocell::parse("x = 3, y = 3\n3o!\n", collect), "macrocell without a header is refused");
+}
+
+// the background loader hands over every cell of a file, whichever reader its extension picks
+auto test_loader() -> void {
+  coord_set_t coords = file_soup(11);
+  for (const auto& extension : {"rle", "mc"}) {
+    std::string path = temporary_path(extension);
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (extension == std::string_view("rle")) {
+      pattern::rle::write(file, std::vector(coords.begin(), coords.end()));
+    } else {
+      std::vector<engine::cell_t> cells;
+      for (const auto& coord : coords) cells.push_back(engine::cell_t{coord, engine::color_t{255, 255, 255}});
+      engine::hashlife::hashlife_t hashlife;
+      engine::hashlife::load(hashlife, cells);
+      pattern::macrocell::write(file, hashlife, "B36/S23");
+    }
+    std::fclose(file);
+
+    pattern::loader::loader_t loader;
+    pattern::loader::start(loader, path);
+    coord_set_t loaded;
+    while (pattern::loader::pending(loader)) pattern::loader::drain(loader, [&loaded](const int x, const int y) { loaded.insert({x, y}); });
+    check(!loader.failed && loaded == coords && loader.parsed == coords.size(), fmt::format("{} loads in the background", extension));
+    check(pattern::loader::rule(path) == (extension == std::string_view("rle") ? "B3/S23" : "B36/S23"), fmt::format("{} rule is read back", extension));
+
+    // cancelling from within the parse stops it at the next row or node rather than the end of the file
+    std::atomic<bool> cancelled{false};
+    size_t parsed = 0;
+    pattern::loader::parse(
+        path,
+        [&cancelled, &parsed](const int, const int) {
+          if (++parsed == 100) cancelled = true;
+        },
+        &cancelled);
+    check(parsed >= 100 && parsed < coords.size() / 2, fmt::format("{} parse stops once cancelled", extension));
+    std::filesystem::remove(path);
+  }
+}
+
+// every stamp keeps its cells in each orientation, four quarter turns or two reflections come back to
+// where they started, and the r-pentomino lands where the pattern always did
+auto test_stamps() -> void {
+  for (const auto& stamp : pattern::stamp::builtin()) {
+    check(!stamp.coords.empty(), stamp.name + " has cells");
+    coord_set_t upright;
+    pattern::stamp::for_each_cell(stamp, 0, 0, 0, [&upright](const int x, const int y) { upright.insert({x, y}); });
+    for (int orientation = 0; orientation < pattern::stamp::orientations; ++orientation) {
+      coord_set_t cells;
+      pattern::stamp::for_each_cell(stamp, orientation, 0, 0, [&cells](const int x, const int y) { cells.insert({x, y}); });
+      coord_set_t undone;
+      for (auto [x, y] : cells) {
+        for (int turn = 0; turn < (orientation & 3); ++turn) {
+          int turned = y;
+          y = -x;
+          x = turned;
+        }
+        undone.insert({pattern::stamp::reflected(orientation) ? -x : x, y});
+      }
+      check(cells.size() == stamp.coords.size() && undone == upright, fmt::format("{} keeps its cells in orientation {}", stamp.name, orientation));
+
+      int turned = orientation;
+      for (int turn = 0; turn < 4; ++turn) turned = pattern::stamp::rotate(turned);
+      check(turned == orientation && pattern::stamp::reflect(pattern::stamp::reflect(orientation)) == orientation, fmt::format("{} orientation {} cycles", stamp.name, orientation));
+    }
+  }
+
+  coord_set_t stamped;
+  pattern::stamp::for_each_cell(pattern::stamp::builtin().front(), 0, 7, 9, [&stamped](const int x, const int y) { stamped.insert({x, y}); });
+  auto rpentomino = pattern::rpentomino(7, 9);
+  check(stamped == coord_set_t(rpentomino.begin(), rpentomino.end()), "r-pentomino stamp is centred");
+
+  std::string path = temporary_path("rle");
+  std::ofstream(path) << "x = 3, y = 3\nbo$2bo$3o!\n";
+  pattern::stamp::stamp_t loaded;
+  check(pattern::stamp::load(path, loaded) && loaded.name == std::filesystem::path(path).filename().string() && loaded.coords == pattern::stamp::builtin()[1].coords, "stamps load from pattern files");
+  std::filesystem::remove(path);
+}
+// ----------------------------------------------
+
+// History --------------------------------------
+// rewinds by a step and by many, undoing backwards or replaying from a keyframe, to boards recorded
+// along the way, in an arena small enough that the oldest keyframes are dropped
+auto test_history() -> void {
+  for (const size_t capacity : {size_t{1} << 22, size_t{1} << 16}) {
+    engine::engine_t engine;
+    engine::select(engine, engine::kind_e::tile);
+    std::vector<engine::cell_t> cells = soup(200, 150, 29);
+    engine::history::history_t history;
+    engine::history::set_capacity(history, capacity);
+
+    std::map<uint64_t, std::vector<engine::cell_t>> boards;
+    auto run = [&](const int steps) {
+      for (int step = 0; step < steps; ++step) {
+        engine::history::prepare(history, cells, engine.generation, true);
+        boards[engine.generation] = sorted(cells);
+        engine::step(engine, cells);
+        engine::history::record(history, cells, engine.generation, true);
+      }
+      boards[engine.generation] = sorted(cells);
+    };
+
+    run(600);
+    check(engine::history::memory_usage(history) <= capacity, "history stays within its arena");
+    for (const uint64_t back : {1, 5, 300, 2, 40, 1000}) {
+      uint64_t generation = engine.generation;
+      bool rewound = engine::history::rewind(history, back, cells, generation);
+      bool reached = generation == std::max(engine.generation > back ? engine.generation - back : 0, engine::history::oldest_generation(history));
+      check(rewound && reached && sorted(cells) == boards[generation], fmt::format("rewind {} from {} in {} bytes", back, engine.generation, capacity));
+      engine.generation = generation;
+      engine::touch(engine);
+    }
+
+    // an edit leaves the recorded board behind, as the simulation marks it, and is kept as a keyframe of its own
+    cells.push_back(engine::cell_t{{1000, 1000}, {1, 2, 3}});
+    history.synced = false;
+    run(50);
+    uint64_t generation = engine.generation;
+    bool rewound = engine::history::rewind(history, 30, cells, generation);
+    bool reached = generation == std::max(engine.generation - 30, engine::history::oldest_generation(history));
+    check(rewound && reached && sorted(cells) == boards[generation], "rewind after an edit and recording again");
+  }
+
+  // the births and deaths a record leaves behind take the board before the step to the one after it
+  engine::engine_t engine;
+  std::vector<engine::cell_t> cells = soup(200, 150, 35);
+  engine::history::history_t history;
+  engine::history::set_capacity(history, size_t{1} << 20);
+  engine::history::prepare(history, cells, engine.generation, true);
+  engine::history::history_t replayed;
+  engine::history::load(replayed, cells);
+  bool replays = true;
+  for (int step = 0; step < 50; ++step) {
+    engine::step(engine, cells);
+    replays = replays && engine::history::record(history, cells, engine.generation, true);
+    engine::history::apply(replayed, history.births, history.deaths);
+    std::vector<engine::cell_t> after;
+    for (size_t slot = 0; slot < replayed.cells.used.size(); ++slot)
+      if (replayed.cells.used[slot]) after.push_back(engine::cell_t{engine::unpack_coord(replayed.cells.keys[slot]), replayed.cells.values[slot].color});
+    replays = replays && sorted(after) == sorted(cells);
+  }
+  check(replays, "each step's changes replay it, keyframes included");
+}
+
+// sorted keys far apart and close together round trip with and without their colours, and bytes
+// that run out or run over are refused
+auto test_encoding() -> void {
+  for (const bool colored : {true, false}) {
+    std::vector<engine::history::change_t> births;
+    std::vector<engine::history::change_t> deaths;
+    for (const auto& cell : soup(200, 150, 30)) births.emplace_back(engine::pack_coord(cell.coord), colored ? cell.color : engine::white);
+    for (const auto& cell : soup(30, 30, 31)) deaths.emplace_back(engine::pack_coord(cell.coord.first * 100000, cell.coord.second), colored ? cell.color : engine::white);
+    std::ranges::sort(births, {}, &engine::history::change_t::first);
+    std::ranges::sort(deaths, {}, &engine::history::change_t::first);
+
+    std::vector<uint8_t> bytes;
+    engine::history::encode(births, deaths, colored, bytes);
+    std::vector<engine::history::change_t> decoded_births;
+    std::vector<engine::history::change_t> decoded_deaths;
+    bool decoded = engine::history::decode(bytes.data(), bytes.size(), colored, decoded_births, decoded_deaths);
+    check(decoded && decoded_births == births && decoded_deaths == deaths, fmt::format("changes round trip, colored {}", colored));
+    check(!engine::history::decode(bytes.data(), bytes.size() / 2, colored, decoded_births, decoded_deaths), "truncated changes are refused");
+    bytes.push_back(0);
+    check(!engine::history::decode(bytes.data(), bytes.size(), colored, decoded_births, decoded_deaths), "changes with trailing bytes are refused");
+  }
+}
+// ----------------------------------------------
+
+// Snapshot -------------------------------------
+auto read_snapshot(const std::string& path, std::vector<engine::cell_t>& cells, uint64_t& generation, std::string& rule) -> bool {
+  pattern::snapshot::view_t view;
+  if (!pattern::snapshot::open(path, view)) return false;
+  cells.clear();
+  pattern::snapshot::for_each_cell(view, [&cells](const int x, const int y, const engine::color_t& color) { cells.push_back(engine::cell_t{{x, y}, color}); });
+  generation = view.header->generation;
+  rule = pattern::snapshot::rule(view);
+  return true;
+}
+
+// boards spanning many tiles, with cells at the far corners, round trip with and without their colours,
+// and damaged files are refused
+auto test_snapshot() -> void {
+  std::string path = temporary_path("snap");
+  std::vector<engine::cell_t> cells = soup(600, 400, 28);
+  cells.push_back(engine::cell_t{{-2000000000, 2000000000}, {1, 2, 3}});
+  cells.push_back(engine::cell_t{{2000000000, -2000000000}, {4, 5, 6}});
+
+  for (const bool colored : {true, false}) {
+    pattern::snapshot::writer_t writer;
+    check(pattern::snapshot::save(writer, path, cells, 1234, "B36/S23", colored), "snapshot save starts");
+    writer.thread.join();
+    check(!writer.failed && !std::filesystem::exists(path + ".tmp"), "snapshot written and renamed into place");
+
+    std::vector<engine::cell_t> expected = cells;
+    if (!colored)
+      for (auto& cell : expected) cell.color = engine::white;
+    std::vector<engine::cell_t> loaded;
+    uint64_t generation = 0;
+    std::string rule;
+    check(read_snapshot(path, loaded, generation, rule) && generation == 1234 && rule == "B36/S23", fmt::format("snapshot header round trip, colored {}", colored));
+    check(sorted(loaded) == sorted(expected), fmt::format("snapshot cells round trip, colored {}", colored));
+  }
+
+  std::string bytes;
+  {
+    std::stringstream text;
+    text << std::ifstream(path, std::ios::binary).rdbuf();
+    bytes = text.str();
+  }
+  auto refused = [&path](const std::string& damaged) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << damaged;
+    std::vector<engine::cell_t> loaded;
+    uint64_t generation = 0;
+    std::string rule;
+    return !read_snapshot(path, loaded, generation, rule);
+  };
+  std::string flipped = bytes;
+  flipped[bytes.size() - 8] ^= 1;
+  check(refused(flipped), "snapshot with a flipped bit is refused");
+  check(refused(bytes.substr(0, bytes.size() - 8)), "truncated snapshot is refused");
+  check(refused(bytes.substr(0, 16)), "snapshot without a whole header is refused");
+  std::filesystem::remove(path);
+
+  // a failed write leaves nothing behind
+  pattern::snapshot::writer_t writer;
+  std::string unwritable = temporary_path("missing") + "/snap";
+  check(pattern::snapshot::save(writer, unwritable, cells, 1, "B3/S23", true), "snapshot save starts");
+  writer.thread.join();
+  check(writer.failed && !std::filesystem::exists(unwritable) && !std::filesystem::exists(unwritable + ".tmp"), "snapshot that cannot be written fails");
+
+  // restore edits each swap in the board, generation and rule queued with them, in order, and a
+  // larger than life rule selects its engine
+  engine::simulation::simulation_t simulation;
+  engine::select(simulation.engine, engine::kind_e::tile);
+  std::vector<engine::cell_t> first(cells.begin(), cells.begin() + cells.size() / 2);
+  engine::simulation::restore(simulation, engine::simulation::restore_t{first, 77, "R2,C0,M1,S6..10,B6..8,NM"});
+  std::swap(simulation.edits, simulation.applying);
+  engine::simulation::apply(simulation);
+  check(sorted(simulation.cells) == sorted(first) && simulation.engine.generation == 77 && simulation.engine.kind == engine::kind_e::ltl, "restore swaps in a board under a larger than life rule");
+
+  engine::simulation::restore(simulation, engine::simulation::restore_t{cells, 78, "B36/S23"});
+  engine::simulation::restore(simulation, engine::simulation::restore_t{first, 79, "B3/S23"});
+  std::swap(simulation.edits, simulation.applying);
+  engine::simulation::apply(simulation);
+  check(sorted(simulation.cells) == sorted(first) && simulation.engine.generation == 79 && simulation.engine.rule == engine::rule::conway, "restores queued together apply in order");
+
+  simulation.applying.push_back(engine::simulation::edit_t{engine::simulation::edit_e::restore, 0, 0, {}});
+  engine::simulation::apply(simulation);
+  check(sorted(simulation.cells) == sorted(first) && simulation.engine.generation == 79, "a restore without a board changes nothing");
+}
+// ----------------------------------------------
+
+// Remote ---------------------------------------
+// serves and takes messages until the viewer has seen the tick of generation with every region it
+// watches in sync
+auto catch_up(remote::publisher::publisher_t& publisher, remote::viewer::viewer_t& viewer, const uint64_t generation) -> bool {
+  auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (std::chrono::steady_clock::now() < give_up) {
+    remote::publisher::serve(publisher);
+    remote::viewer::update(viewer);
+    if (viewer.generation == generation && remote::viewer::synced_regions(viewer) == viewer.watched.size()) return true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return false;
+}
+
+// viewers joining a paused publisher sync at once and then follow every step, one watching the whole
+// board and one a single region of it, with the changes shared from the history on every other step
+// and diffed by the publisher on the rest
+auto test_remote() -> void {
+  remote::publisher::publisher_t publisher;
+  if (!remote::publisher::start(publisher, "inproc://life_test_remote")) {
+    check(false, "publisher binds");
+    return;
+  }
+
+  engine::engine_t engine;
+  engine::select(engine, engine::kind_e::tile);
+  std::vector<engine::cell_t> cells = soup(400, 400, 33);
+  engine::history::history_t history;
+  engine::history::set_capacity(history, size_t{16} << 20);
+  remote::publisher::publish(publisher, cells, engine.generation, true, engine.revision);
+
+  remote::viewer::viewer_t whole;
+  remote::viewer::viewer_t corner;
+  remote::viewer::connect(whole, "inproc://life_test_remote");
+  remote::viewer::connect(corner, "inproc://life_test_remote");
+  remote::viewer::watch(whole, -512, -512, 511, 511);
+  remote::viewer::watch(corner, 0, 0, 255, 255);
+
+  auto shown = [](const remote::viewer::viewer_t& viewer) {
+    std::vector<engine::cell_t> cells;
+    remote::viewer::cells(viewer, cells);
+    return sorted(cells);
+  };
+  auto in_corner = [](const std::vector<engine::cell_t>& cells) {
+    std::vector<engine::cell_t> kept;
+    for (const auto& cell : cells)
+      if (remote::region_key(cell.coord.first, cell.coord.second) == engine::pack_coord(0, 0)) kept.push_back(cell);
+    return sorted(kept);
+  };
+  bool joined = catch_up(publisher, whole, engine.generation) && catch_up(publisher, corner, engine.generation);
+  check(joined && shown(whole) == sorted(cells) && shown(corner) == in_corner(cells), "viewers joining a paused publisher sync at once");
+
+  for (int step = 0; step < 200; ++step) {
+    engine::history::prepare(history, cells, engine.generation, true);
+    uint64_t from = engine.revision;
+    engine::step(engine, cells);
+    bool diffed = engine::history::record(history, cells, engine.generation, true);
+    engine::history::delta_t delta{from, engine.revision, &history.births, &history.deaths};
+    remote::publisher::publish(publisher, cells, engine.generation, true, engine.revision, diffed && step % 2 == 0 ? &delta : nullptr);
+    if (!catch_up(publisher, whole, engine.generation) || !catch_up(publisher, corner, engine.generation) || shown(whole) != sorted(cells) || shown(corner) != in_corner(cells)) {
+      check(false, fmt::format("viewers follow the publisher at generation {}", engine.generation));
+      return;
+    }
+  }
+  check(whole.desyncs == 0 && corner.desyncs == 0 && whole.population == cells.size(), "viewers never desync");
+}
+// ----------------------------------------------
+
+// Profile --------------------------------------
+// the window keeps the most recent samples, and the sparse engine counts births and deaths as the
+// brute force sees them
+auto test_profile() -> void {
+  if constexpr (!profile::enabled) return;
+
+  for (uint64_t sample = 1; sample <= 2000; ++sample) profile::record(profile::timer_e::render_display, sample);
+  std::vector<uint64_t> scratch;
+  auto summary = profile::summarize(profile::timer_e::render_display, scratch);
+  check(summary.count == 2000 && summary.p50 == 1489 && summary.p99 == 1990 && summary.max == 2000, "timer percentiles over the window");
+
+  engine::engine_t engine;
+  std::vector<engine::cell_t> cells = soup(200, 150, 19);
+  board_t expected = board(cells);
+  uint64_t births = 0;
+  uint64_t deaths = 0;
+  for (int step = 0; step < 20; ++step) {
+    board_t next = brute_step(expected);
+    for (const auto& [key, color] : next) births += !expected.contains(key);
+    for (const auto& [key, color] : expected) deaths += !next.contains(key);
+    expected = std::move(next);
+  }
+  uint64_t counted_births = profile::total(profile::counter_e::births);
+  uint64_t counted_deaths = profile::total(profile::counter_e::deaths);
+  for (int step = 0; step < 20; ++step) engine::step(engine, cells);
+  check(profile::total(profile::counter_e::births) - counted_births == births && profile::total(profile::counter_e::deaths) - counted_deaths == deaths, "sparse engine counts births and deaths");
+}
+
+// a capture of the tile engine on several threads is written as a whole trace event document
+auto test_trace() -> void {
+  if constexpr (!profile::enabled) return;
+
+  engine::engine_t engine;
+  engine::select(engine, engine::kind_e::tile);
+  engine::set_threads(engine, 4);
+  std::vector<engine::cell_t> cells = soup(400, 300, 20);
+  engine::step(engine, cells);
+
+  profile::trace::name_thread("test");
+  profile::trace::start();
+  for (int step = 0; step < 10; ++step) engine::step(engine, cells);
+  profile::trace::stop();
+  engine::step(engine, cells);
+
+  std::string path = temporary_path("json");
+  check(profile::trace::write(path.c_str()), "trace written");
+  std::stringstream text;
+  text << std::ifstream(path).rdbuf();
+  std::string trace = text.str();
+  std::filesystem::remove(path);
+
+  auto occurrences = [&trace](const std::string_view needle) {
+    size_t count = 0;
+    for (size_t position = trace.find(needle); position != std::string::npos; position = trace.find(needle, position + 1)) ++count;
+    return count;
+  };
+  check(trace.starts_with("{\"traceEvents\": [\n") && trace.ends_with("\n]}\n"), "trace is one document");
+  check(occurrences("\"name\": \"engine_step\", \"ph\": \"X\"") == 10 && occurrences("\"name\": \"pool_work\"") >= 10, "trace keeps the captured scopes only");
+  check(occurrences("\"args\": {\"name\": \"test\"}") == 1, "trace names its threads");
+}
+
+// blocks and blinkers spread over several tiles settle at once, after which a warmed up engine
+// steps on its retained buffers without touching the heap
+auto test_allocation() -> void {
+  std::vector<engine::cell_t> stable;
+  for (int y = -150; y < 150; y += 10) {
+    for (int x = -200; x < 200; x += 10) {
+      if ((x + y) / 10 % 2 == 0)
+        for (const auto& coord : {std::pair{x, y}, {x + 1, y}, {x, y + 1}, {x + 1, y + 1}}) stable.push_back(engine::cell_t{coord, {200, 100, 50}});
+      else
+        for (const auto& coord : {std::pair{x, y}, {x + 1, y}, {x + 2, y}}) stable.push_back(engine::cell_t{coord, {50, 100, 200}});
+    }
+  }
+
+  for (const auto kind : {engine::kind_e::sparse, engine::kind_e::tile, engine::kind_e::hashlife}) {
+    for (const bool finite : {false, true}) {
+      if (finite && kind != engine::kind_e::sparse) continue;
+      engine::engine_t engine;
+      engine::select(engine, kind);
+      if (finite) engine::set_world(engine, engine::world::topology_e::torus, 500, 400);
+      std::vector<engine::cell_t> cells = stable;
+      for (int step = 0; step < 8; ++step) engine::step(engine, cells);
+
+      profile::allocation::watch_t watch;
+      for (int step = 0; step < 20; ++step) engine::step(engine, cells);
+      uint64_t allocated = watch.allocated();
+      check(allocated == 0, fmt::format("{} steps without allocating once warm", finite ? "finite world" : engine::kind_name(kind)));
+    }
+  }
+}
+// ----------------------------------------------
+
+auto main() -> int {
+  test_parse();
+  test_sparse();
+  test_table();
+  test_tiles();
+  test_tile_threads();
+  test_tile_skipping();
+  test_pool();
+  test_hashlife();
+  test_hashlife_memory();
+  test_colors();
+  test_rules();
+  test_rulestrings();
+  test_ltl();
+  test_worlds();
+  test_layout();
+  test_shards();
+  test_index();
+  test_pyramid();
+  test_edits();
+  test_simulation();
+  test_plaintext();
+  test_soup();
+  test_rpentomino();
+  test_canonical();
+  test_rle();
+  test_macrocell();
+  test_loader();
+  test_stamps();
+  test_history();
+  test_encoding();
+  test_snapshot();
+  test_remote();
+  test_profile();
+  test_trace();
+  test_allocation();
+
+  if (failures > 0) {
+    fmt::print("{} failed\n", failures);
+    return 1;
+  }
+  fmt::print("passed\n");
+  return 0;
+}